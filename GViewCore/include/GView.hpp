@@ -45,6 +45,10 @@ struct CORE_EXPORT TypeInterface {
     virtual std::string_view GetTypeName()                        = 0;
     virtual void RunCommand(std::string_view commandName)         = 0;
     virtual bool UpdateKeys(KeyboardControlsInterface* interface) = 0;
+    // called before the object (and its data cache) is destroyed, background work that reads the data must stop
+    virtual void OnObjectClose()
+    {
+    }
 
     virtual ~TypeInterface()
     {
@@ -94,42 +98,132 @@ namespace Utils
 
         void PopulateListView(AppCUI::Utils::Reference<AppCUI::Controls::ListView> listView) const;
     };
+    class CORE_EXPORT ChunkRange;
     class CORE_EXPORT DataCache
     {
         AppCUI::OS::DataObject* fileObj;
-        uint64 fileSize, start, end, currentPos;
-        uint8* cache;
-        uint32 cacheSize;
+        uint64 fileSize, currentPos;
+        uint8* cache; // memory for the cached pages and the window where multi page requests are stitched
+        uint32 cacheSize; // the largest request served at once (the size given to Init, pages and read ahead are allocated on top)
+        void* pages; // LRU list of the cached pages
+        uint64 hits, misses;
+        const uint8* mappedData; // the entire file (memory mapped mode) or nullptr
+        void* mappingHandle;
+        void* statistics; // I/O counters and the counters of every subsystem (see Tag)
 
         bool CopyObject(void* buffer, uint64 offset, uint32 requestedSize);
+        bool ReadChunk(uint64 offset, uint8* buffer, uint32 size);
+
+        friend class ChunkRange;
 
       public:
+        enum class AccessPattern : uint8 {
+            Auto, // forward sequential scans are detected and read ahead
+            Sequential,
+            Random,
+        };
+        struct Range {
+            uint64 offset;
+            uint64 size;
+        };
+        static constexpr uint32 LATENCY_BUCKETS = 24;
+        struct Statistics {
+            struct Subsystem {
+                std::string name; // empty for the requests that were not tagged
+                uint64 requests, requestedBytes, hits, misses;
+            };
+            uint64 hits, misses; // page lookups
+            // reads from the file: page refills, read ahead, prefetched ranges and ReadAt
+            uint64 reads, failedReads, bytesRead;
+            // latency[i] = reads that took less than 2^i microseconds (and at least 2^(i-1)), the last bucket has no upper limit
+            uint64 latency[LATENCY_BUCKETS];
+            uint64 largestRequest;
+            std::vector<Subsystem> subsystems;
+        };
+        // while a Tag is alive the requests are accounted to a subsystem (e.g. "PE.Resources") in the statistics
+        class CORE_EXPORT Tag
+        {
+            DataCache& cache;
+            uint32 previous;
+
+          public:
+            Tag(DataCache& cache, std::string_view subsystem);
+            Tag(const Tag&)            = delete;
+            Tag& operator=(const Tag&) = delete;
+            ~Tag();
+        };
+        // while a HintGuard is alive the requests use an access pattern (Auto is restored when it is destroyed)
+        class HintGuard
+        {
+            DataCache& cache;
+
+          public:
+            HintGuard(DataCache& _cache, AccessPattern pattern) : cache(_cache)
+            {
+                cache.Hint(pattern);
+            }
+            HintGuard(const HintGuard&)            = delete;
+            HintGuard& operator=(const HintGuard&) = delete;
+            ~HintGuard()
+            {
+                cache.Hint(AccessPattern::Auto);
+            }
+        };
+
         DataCache();
         DataCache(DataCache&& obj);
         ~DataCache();
 
         bool Init(std::unique_ptr<AppCUI::OS::DataObject> file, uint32 cacheSize);
+        // maps a regular file in memory: Get returns views straight into the mapping (the cached pages are released)
+        // the file must not be truncated while it is mapped (reading past its new end raises SIGBUS / an in-page error)
+        bool MapFile(const std::filesystem::path& path);
+        // reads the file through a separate handle with positional reads instead of the data object (batchedReads: the read
+        // ahead and prefetch blocks are read together with io_uring on Linux, elsewhere it has no effect)
+        bool OpenReader(const std::filesystem::path& path, bool batchedReads = true);
+        inline bool IsMapped() const
+        {
+            return mappedData != nullptr;
+        }
         BufferView Get(uint64 offset, uint32 requestedSize, bool failIfRequestedSizeCanNotBeRead);
+        // how the next Get calls will read the data (Sequential reads ahead on a worker thread, Random never does)
+        void Hint(AccessPattern pattern);
+        // announces ranges that will be read soon: they are loaded together on a worker thread (up to cacheSize / 4 bytes)
+        bool Prefetch(std::span<const Range> ranges);
         inline BufferView GetEntireFile()
         {
-            return fileSize < 0xFFFFFFFF ? Get(0, (uint32) fileSize, true) : BufferView();
+            if (mappedData)
+                return BufferView(mappedData, (size_t) fileSize);
+            // without a mapping only the files that fit in the cache can be viewed at once (CopyEntireFile has no such limit)
+            return fileSize <= cacheSize ? Get(0, (uint32) fileSize, true) : BufferView();
         }
 
-        Buffer CopyToBuffer(uint64 offset, uint32 requestedSize, bool failIfRequestedSizeCanNotBeRead = true);
+        // thread safe: copies output.size() bytes straight into the caller memory (the cached pages and the current position are not used)
+        bool ReadAt(uint64 offset, std::span<uint8> output);
+
+        Buffer CopyToBuffer(uint64 offset, uint64 requestedSize, bool failIfRequestedSizeCanNotBeRead = true);
         inline Buffer CopyEntireFile(bool failIfRequestedSizeCanNotBeRead = true)
         {
-            return CopyToBuffer(0, (uint32) fileSize, failIfRequestedSizeCanNotBeRead);
-        }
-        inline uint8 GetFromCache(uint64 offset, uint8 defaultValue = 0) const
-        {
-            if ((offset >= start) && (offset < end))
-                return cache[offset - start];
-            return defaultValue;
+            return CopyToBuffer(0, fileSize, failIfRequestedSizeCanNotBeRead);
         }
+        uint8 GetFromCache(uint64 offset, uint8 defaultValue = 0) const;
         inline uint32 GetCacheSize() const
         {
             return cacheSize;
         }
+        // number of page lookups that were served from memory / had to be read from the file
+        inline uint64 GetHitsCount() const
+        {
+            return hits;
+        }
+        inline uint64 GetMissesCount() const
+        {
+            return misses;
+        }
+        Statistics GetStatistics() const;
+        void ResetStatistics();
+        // writes the statistics as text (used to tune the CacheSize setting and to find plugins with bad access patterns)
+        bool WriteStatistics(const std::filesystem::path& path) const;
 
         inline uint64 GetSize() const
         {
@@ -150,9 +244,119 @@ namespace Utils
             return CopyObject(&object, offset, sizeof(T));
         }
 
-        bool WriteTo(Reference<AppCUI::OS::DataObject> output, uint64 offset, uint32 size);
+        bool WriteTo(Reference<AppCUI::OS::DataObject> output, uint64 offset, uint64 size);
+
+        // splits [offset, offset+size) in chunks of chunkSize bytes, each one starting with the last 'overlap' bytes of the previous one
+        ChunkRange Chunks(uint64 offset, uint64 size, uint32 chunkSize, uint32 overlap = 0);
     };
 
+    // single pass range over the chunks of a DataCache (the view of a chunk is valid until the next one is read)
+    // mapped objects are not copied, for the other ones the overlap is moved at the start of the chunk and only the rest is read
+    class CORE_EXPORT ChunkRange
+    {
+      public:
+        struct Chunk {
+            uint64 offset;
+            BufferView data;
+        };
+        class Iterator
+        {
+            ChunkRange* range;
+
+          public:
+            Iterator(ChunkRange* range) : range(range)
+            {
+            }
+            inline const Chunk& operator*() const
+            {
+                return range->current;
+            }
+            inline Iterator& operator++()
+            {
+                if (!range->Next())
+                    range = nullptr;
+                return *this;
+            }
+            inline bool operator!=(const Iterator& other) const
+            {
+                return range != other.range;
+            }
+        };
+
+      private:
+        DataCache* cache;
+        uint64 position, rangeEnd;
+        uint32 chunkSize, overlap;
+        Buffer buffer;
+        Chunk current;
+        bool started, failed;
+
+        bool Next();
+
+      public:
+        ChunkRange(DataCache* cache, uint64 offset, uint64 size, uint32 chunkSize, uint32 overlap);
+        ChunkRange(const ChunkRange&)            = delete;
+        ChunkRange& operator=(const ChunkRange&) = delete;
+
+        Iterator begin();
+        inline Iterator end()
+        {
+            return Iterator(nullptr);
+        }
+        // true if the iteration stopped because some data could not be read
+        inline bool HasFailed() const
+        {
+            return failed;
+        }
+    };
+
+    // process wide cache of decoded objects (decompressed streams, archive members, images) shared by all the windows
+    // an object is found by a hash of the bytes it was decoded from (or of what identifies them, such as their stored CRCs) and
+    // the transform that decoded it, the least recently used objects are dropped when their total size goes over the memory budget
+    namespace DecodedObjects
+    {
+        enum class Transform : uint32 {
+            Base64   = 1,
+            ZLib     = 2,
+            ZipEntry = 3,
+            PngImage = 4,
+        };
+        struct Key {
+            uint64 hash[2];
+            uint64 sourceSize;
+            uint64 parameter; // transform specific (the offset of a stream in the source, the scale of an image ...)
+            Transform transform;
+
+            inline bool operator==(const Key& other) const
+            {
+                return hash[0] == other.hash[0] && hash[1] == other.hash[1] && sourceSize == other.sourceSize && parameter == other.parameter &&
+                       transform == other.transform;
+            }
+        };
+        // fast (non cryptographic) 128 bits hash, the source can be added in pieces
+        class CORE_EXPORT KeyBuilder
+        {
+            uint64 lanes[4];
+            uint8 pending[32];
+            uint32 pendingSize;
+            uint64 size;
+
+          public:
+            KeyBuilder();
+            void Update(BufferView data);
+            Key GetKey(Transform transform, uint64 parameter = 0) const;
+        };
+        CORE_EXPORT Key ComputeKey(BufferView source, Transform transform, uint64 parameter = 0);
+
+        // output receives a copy of the object, consumed (if requested) the number of source bytes that were decoded
+        CORE_EXPORT bool Find(const Key& key, Buffer& output, uint64* consumed = nullptr);
+        // objects larger than the memory budget are not kept
+        CORE_EXPORT void Add(const Key& key, BufferView object, uint64 consumed = 0);
+        CORE_EXPORT void SetMemoryBudget(uint64 size);
+        CORE_EXPORT uint64 GetMemoryBudget();
+        CORE_EXPORT uint64 GetMemoryUsage();
+    } // namespace DecodedObjects
+
     enum class DemangleKind : uint8 {
         Auto,
         Microsoft,
@@ -273,6 +477,8 @@ namespace Hashes
         bool Update(const BufferView& buffer);
         bool Final(uint32& hash);
         static std::string_view GetName(CRC32Type type);
+        // CRC of the concatenation A + B from the final CRC32 (JAMCRC type) values of A and B
+        static uint32 Combine(uint32 crc1, uint32 crc2, uint64 length2);
         const std::string_view GetHexValue();
 
       public:
@@ -630,6 +836,32 @@ namespace Decoding
     {
         CORE_EXPORT bool Decompress(const Buffer& input, uint64 inputSize, Buffer& output, uint64 outputSize);
         CORE_EXPORT bool DecompressStream(const BufferView& input, Buffer& output, String& message, uint64& sizeConsumed);
+
+        enum class DeflateBlockType : uint8 { Stored = 0, FixedHuffman = 1, DynamicHuffman = 2, Reserved = 3 };
+
+        // incremental inflater: the caller pushes compressed data in slices (SetInput) and pulls
+        // the decompressed bytes in chunks of any size (Inflate) - only the zlib window is kept alive
+        class CORE_EXPORT StreamInflater
+        {
+            void* context;
+
+          public:
+            StreamInflater();
+            ~StreamInflater();
+
+            // rawDeflate: the stream has no zlib header and no adler32 trailer
+            bool Init(bool rawDeflate = false);
+            void SetInput(const BufferView& input);
+            bool Inflate(uint8* output, uint32 outputSize, uint32& written);
+            bool NeedsInput() const;
+            bool IsFinished() const;
+            uint64 GetTotalIn() const;
+            uint64 GetTotalOut() const;
+
+            // when enabled, Inflate stops internally at every deflate block boundary to count the blocks by type
+            void SetBlockCounting(bool enabled);
+            uint32 GetBlockCount(DeflateBlockType type) const;
+        };
     } // namespace ZLIB
 
     namespace ZIP
@@ -800,6 +1032,26 @@ namespace Regex
 
         bool Match(BufferView buffer, uint64& start, uint64& end);
     };
+
+    // expressions searched together: one linear pass over a buffer (a single combined automaton) finds which of them match
+    // anywhere in it, the offsets of the matches are then found only for those expressions
+    struct CORE_EXPORT MatcherSet {
+      private:
+        void* context{ nullptr };
+
+      public:
+        bool Init(bool isCaseSensitive);
+        // index of the expression (in the order they are added) or -1 if it is not valid
+        int32 Add(std::string_view expression);
+        bool Compile();
+        MatcherSet() = default;
+        ~MatcherSet();
+
+        // appends the indexes of the expressions that match somewhere in the buffer
+        bool Match(BufferView buffer, std::vector<uint32>& expressions);
+        // leftmost match of an expression that starts at or after 'from'
+        bool Find(uint32 expression, BufferView buffer, uint64 from, uint64& start, uint64& end);
+    };
 } // namespace Regex
 
 namespace Entropy
@@ -835,6 +1087,11 @@ class CORE_EXPORT Object
         if (contentType)
             contentType->obj = this;
     }
+    ~Object()
+    {
+        if (contentType)
+            contentType->OnObjectClose();
+    }
     inline Utils::DataCache& GetData()
     {
         return cache;
@@ -992,8 +1249,42 @@ namespace View
 
     namespace ImageViewer
     {
+        // Box filter used to decode an image directly at a reduced size: every pixel of the reduced image is the
+        // average of a `divider` x `divider` block of the full resolution image. Only the reduced image is kept in memory.
+        class CORE_EXPORT ImageDownscaler
+        {
+            void* context;
+
+          public:
+            ImageDownscaler();
+            ~ImageDownscaler();
+
+            bool Init(uint32 width, uint32 height, uint32 divider);
+            // pixels of the full resolution image can be added in any order (e.g. Adam7 passes)
+            void AddPixel(uint32 x, uint32 y, Pixel px);
+            void AddRow(uint32 y, const Pixel* row, uint32 count);
+            bool Finish(Image& img);
+
+            uint32 GetDivider() const;
+        };
+        struct CORE_EXPORT LoadImageProgressInterface {
+            // called every time `img` was refined (e.g. after each Adam7 pass); returns false to cancel the loading
+            virtual bool OnImageLoadProgress(Image& img, uint32 step, uint32 stepsCount) = 0;
+        };
         struct CORE_EXPORT LoadImageInterface {
             virtual bool LoadImageToObject(Image& img, uint32 index) = 0;
+            // progressive loading: `img` is created with its final size and refined in several steps, `progress` being
+            // notified after each one so that a coarse preview can be displayed (by default the image is loaded in one step)
+            virtual bool LoadImageToObjectProgressive(Image& img, uint32 index, Reference<LoadImageProgressInterface> progress)
+            {
+                return LoadImageToObject(img, index);
+            }
+            // loads the image already reduced `divider` times (see ImageDownscaler) so that zoomed out views never need the
+            // full resolution image; returns false if not supported (the viewer then scales the full resolution image)
+            virtual bool LoadImageToObjectScaled(Image& img, uint32 index, uint32 divider)
+            {
+                return false;
+            }
         };
         struct CORE_EXPORT Settings {
             void* data;
@@ -3,14 +3,17 @@
 using namespace GView::App;
 using namespace GView::View;
 
-constexpr int32 BUTTON_ID_CLOSE = 1;
-constexpr int32 BUTTON_ID_GOTO  = 2;
+constexpr int32 BUTTON_ID_CLOSE      = 1;
+constexpr int32 BUTTON_ID_GOTO       = 2;
+constexpr int32 BUTTON_ID_SAVE_STATS = 3;
 
-FileWindowProperties::FileWindowProperties(Reference<Tab> viewContainer) : Window("Properties", "d:c,w:78,h:24", WindowFlags::None)
+FileWindowProperties::FileWindowProperties(Reference<Tab> viewContainer, Reference<GView::Object> _object)
+    : Window("Properties", "d:c,w:78,h:24", WindowFlags::None), object(_object)
 {
     auto t = Factory::Tab::Create(this, "l:1,t:1,r:1,b:3", TabFlags::LeftTabs | TabFlags::TabsBar);
 
     Factory::TabPage::Create(t, "General");
+    AddCacheStatistics(Factory::TabPage::Create(t, "Cache Stats"));
 
     // process all view modes
     for (uint32 idx = 0; idx < viewContainer->GetChildrenCount(); idx++)
@@ -23,8 +26,64 @@ FileWindowProperties::FileWindowProperties(Reference<Tab> viewContainer) : Windo
         }
     }
 
-    Factory::Button::Create(this, "&Close", "x:40%,y:22,a:b,w:12", BUTTON_ID_CLOSE);
-    Factory::Button::Create(this, "&Go To", "x:60%,y:22,a:b,w:12", BUTTON_ID_GOTO);
+    Factory::Button::Create(this, "&Close", "x:25%,y:22,a:b,w:12", BUTTON_ID_CLOSE);
+    Factory::Button::Create(this, "&Go To", "x:50%,y:22,a:b,w:12", BUTTON_ID_GOTO);
+    Factory::Button::Create(this, "&Save Stats", "x:75%,y:22,a:b,w:14", BUTTON_ID_SAVE_STATS);
+}
+void FileWindowProperties::AddCacheStatistics(Reference<TabPage> page)
+{
+    auto list = Factory::ListView::Create(page, "d:c", { "n:Field,w:20", "n:Value,w:100" }, ListViewFlags::None);
+
+    LocalString<128> tempStr;
+    NumericFormatter n;
+    auto& cache        = object->GetData();
+    const auto stats   = cache.GetStatistics();
+    const auto lookups = stats.hits + stats.misses;
+
+    list->AddItem("Cache");
+    list->AddItem({ "Cache Size", tempStr.Format("%s bytes", n.ToString(cache.GetCacheSize(), { NumericFormatFlags::None, 10, 3, ',' }).data()) });
+    list->AddItem({ "Memory Mapped", cache.IsMapped() ? "yes" : "no" });
+    list->AddItem({ "Page Hits", tempStr.Format("%llu", stats.hits) });
+    list->AddItem({ "Page Misses", tempStr.Format("%llu", stats.misses) });
+    if (lookups > 0)
+        list->AddItem({ "Hit Rate", tempStr.Format("%.2f%%", (double) stats.hits * 100.0 / (double) lookups) });
+    list->AddItem({ "Largest Request", tempStr.Format("%s bytes", n.ToString(stats.largestRequest, { NumericFormatFlags::None, 10, 3, ',' }).data()) });
+
+    list->AddItem("File Reads");
+    list->AddItem({ "Reads", tempStr.Format("%llu (%llu failed)", stats.reads, stats.failedReads) });
+    list->AddItem({ "Bytes Read", tempStr.Format("%s bytes", n.ToString(stats.bytesRead, { NumericFormatFlags::None, 10, 3, ',' }).data()) });
+
+    // latency[i] counts the reads that took less than 2^i microseconds
+    list->AddItem("Read Latency");
+    LocalString<32> limit;
+    for (uint32 index = 0; index < GView::Utils::DataCache::LATENCY_BUCKETS; index++)
+    {
+        if (stats.latency[index] == 0)
+            continue;
+        const auto label = (index + 1 == GView::Utils::DataCache::LATENCY_BUCKETS) ? limit.Format(">= %llu us", 1ULL << (index - 1))
+                                                                                    : limit.Format("< %llu us", 1ULL << index);
+        list->AddItem({ label, tempStr.Format("%llu", stats.latency[index]) });
+    }
+
+    list->AddItem("Subsystems");
+    for (const auto& subsystem : stats.subsystems)
+    {
+        list->AddItem({ subsystem.name.empty() ? std::string_view("(not tagged)") : std::string_view(subsystem.name),
+                        tempStr.Format("%llu requests, %llu bytes, %llu hits, %llu misses",
+                                       subsystem.requests,
+                                       subsystem.requestedBytes,
+                                       subsystem.hits,
+                                       subsystem.misses) });
+    }
+}
+void FileWindowProperties::SaveCacheStatistics()
+{
+    auto res = Dialogs::FileDialog::ShowSaveFileWindow("cache_stats.txt", "", "");
+    if (res.has_value())
+    {
+        if (object->GetData().WriteStatistics(res.value()) == false)
+            Dialogs::MessageBox::ShowError("Error", "Fail to write the cache statistics !");
+    }
 }
 bool FileWindowProperties::OnEvent(Reference<Control> control, Event eventType, int ID)
 {
@@ -37,6 +96,11 @@ bool FileWindowProperties::OnEvent(Reference<Control> control, Event eventType,
             this->Exit(Dialogs::Result::Ok);
             return true;
         }
+        if (ID == BUTTON_ID_SAVE_STATS)
+        {
+            SaveCacheStatistics();
+            return true;
+        }
         if (ID == BUTTON_ID_GOTO)
         {
             //GDT: switch to that particular view
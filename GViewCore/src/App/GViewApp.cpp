@@ -15,6 +15,7 @@ using namespace AppCUI::Utils;
 GView::App::Instance* gviewAppInstance = nullptr;
 
 constexpr uint32 DEFAULT_CACHE_SIZE = 0xA00000; // 10 MB // sync this with the one from App/Instance.cpp
+constexpr uint32 DEFAULT_DECODED_OBJECTS_CACHE_SIZE = 0x10000000; // 256 MB // sync this with the one from App/Instance.cpp
 
 bool UpdateSettingsForTypePlugin(AppCUI::Utils::IniObject& ini, const std::filesystem::path& pluginPath)
 {
@@ -97,7 +98,10 @@ bool GView::App::ResetConfiguration()
     }
 
     // generic GView settings
-    ini["GView"]["CacheSize"]        = DEFAULT_CACHE_SIZE;
+    ini["GView"]["CacheSize"]               = DEFAULT_CACHE_SIZE;
+    ini["GView"]["DecodedObjectsCacheSize"] = DEFAULT_DECODED_OBJECTS_CACHE_SIZE;
+    ini["GView"]["MapFiles"]                = false;
+    ini["GView"]["BatchedReads"]            = true;
 
     const std::array<std::reference_wrapper<KeyboardControl>, 6> localKeys = {
         InstanceCommands::INSTANCE_CHANGE_VIEW,     InstanceCommands::INSTANCE_SWITCH_TO_VIEW, InstanceCommands::INSTANCE_COMMAND_GOTO,
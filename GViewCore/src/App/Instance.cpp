@@ -13,6 +13,9 @@ constexpr uint32 MIN_CACHE_SIZE        = 0x10000;  // 64 K
 constexpr uint32 GENERIC_PLUGINS_CMDID = 40000000;
 constexpr uint32 GENERIC_PLUGINS_FRAME = 100;
 
+// memory for the decoded objects shared by all the windows
+constexpr uint32 DEFAULT_DECODED_OBJECTS_CACHE_SIZE = 0x10000000; // 256 MB
+
 struct GViewMenuCommand {
     std::string_view name;
     int commandID;
@@ -68,6 +71,8 @@ bool AddMenuCommands(Menu* mnu, const GViewMenuCommand* list, size_t count)
 Instance::Instance()
 {
     this->defaultCacheSize         = DEFAULT_CACHE_SIZE;
+    this->mapFiles                 = false;
+    this->batchedReads             = true;
     this->mnuWindow                = nullptr;
     this->mnuHelp                  = nullptr;
     this->mnuFile                  = nullptr;
@@ -105,6 +110,9 @@ bool Instance::LoadSettings()
     // read instance settings
     auto sect                                  = ini->GetSection("GView");
     this->defaultCacheSize                     = std::max<>(sect.GetValue("CacheSize").ToUInt32(DEFAULT_CACHE_SIZE), MIN_CACHE_SIZE);
+    this->mapFiles                             = sect.GetValue("MapFiles").ToBool(false);
+    this->batchedReads                         = sect.GetValue("BatchedReads").ToBool(true);
+    GView::Utils::DecodedObjects::SetMemoryBudget(sect.GetValue("DecodedObjectsCacheSize").ToUInt32(DEFAULT_DECODED_OBJECTS_CACHE_SIZE));
 
     const std::array<std::reference_wrapper<KeyboardControl>, 6> localKeys = {
         InstanceCommands::INSTANCE_CHANGE_VIEW,     InstanceCommands::INSTANCE_SWITCH_TO_VIEW, InstanceCommands::INSTANCE_COMMAND_GOTO,
@@ -375,6 +383,16 @@ bool Instance::Add(
     // extract extension
     LocalUnicodeStringBuilder<256> temp;
     CHECK(temp.Set(path), false, "Fail to get path object");
+
+    // regular files are read with positional reads (or memory mapped, if the MapFiles setting is on: a mapping is faster but
+    // accessing it after another process truncated the file raises SIGBUS / an in-page error), processes and memory buffers
+    // keep using the data object
+    if (objType == Object::Type::File) {
+        const std::filesystem::path filePath(temp.ToStringView());
+        if ((!this->mapFiles) || (!cache.MapFile(filePath))) {
+            cache.OpenReader(filePath, this->batchedReads);
+        }
+    }
     // search for the last "."
     auto pos = temp.ToStringView().find_last_of('.');
     auto extHash =
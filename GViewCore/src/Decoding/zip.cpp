@@ -301,6 +301,25 @@ bool Entry::IsEncrypted() const
     return (entry->flag & MZ_ZIP_FLAG_ENCRYPTED);
 }
 
+// decompressed members are shared (Utils::DecodedObjects) by their description from the central directory (the CRC32 and the
+// size of the decompressed data, the compressed size and the method) together with the password, nothing is read to build the
+// key. Members that would not be kept (larger than the memory budget) or without a CRC32 (AES encrypted) are not shared.
+static bool GetEntryKey(const _Entry& entry, const std::string& password, Utils::DecodedObjects::Key& key)
+{
+    CHECK(entry.compressed_size >= 0 && entry.uncompressed_size >= 0, false, "");
+    if ((uint64) entry.uncompressed_size > Utils::DecodedObjects::GetMemoryBudget() || (entry.crc == 0 && entry.uncompressed_size > 0))
+        return false;
+
+    Utils::DecodedObjects::KeyBuilder builder;
+    builder.Update(BufferView(&entry.crc, sizeof(entry.crc)));
+    builder.Update(BufferView(&entry.compressed_size, sizeof(entry.compressed_size)));
+    builder.Update(BufferView(&entry.uncompressed_size, sizeof(entry.uncompressed_size)));
+    builder.Update(BufferView(&entry.compression_method, sizeof(entry.compression_method)));
+    builder.Update(BufferView(password.data(), password.size()));
+    key = builder.GetKey(Utils::DecodedObjects::Transform::ZipEntry);
+    return true;
+}
+
 bool Info::Decompress(Buffer& output, uint32 index, const std::string& password) const
 {
     CHECK(context != nullptr, false, "");
@@ -310,6 +329,11 @@ bool Info::Decompress(Buffer& output, uint32 index, const std::string& password)
     auto& entry = info->entries.at(index);
     CHECK(entry.type == EntryType::File, false, "");
 
+    Utils::DecodedObjects::Key key;
+    const bool shared = GetEntryKey(entry, password, key);
+    if (shared && Utils::DecodedObjects::Find(key, output))
+        return true;
+
     mz_zip_reader_create_ptr reader{ mz_zip_reader_create() };
     mz_zip_reader_set_password(reader.value, password.c_str());
     mz_zip_reader_set_pattern(reader.value, (char*) entry.filename.data(), 0);
@@ -321,6 +345,8 @@ bool Info::Decompress(Buffer& output, uint32 index, const std::string& password)
     CHECK(mz_zip_reader_entry_save_buffer(reader.value, output.GetData(), (int32_t) entry.uncompressed_size) == MZ_OK, false, "");
 
     output.Resize(entry.uncompressed_size);
+    if (shared)
+        Utils::DecodedObjects::Add(key, output);
 
     return true;
 }
@@ -334,6 +360,11 @@ bool Info::Decompress(const BufferView& input, Buffer& output, uint32 index, con
     auto& entry = info->entries.at(index);
     CHECK(entry.type == EntryType::File, false, "");
 
+    Utils::DecodedObjects::Key key;
+    const bool shared = GetEntryKey(entry, password, key);
+    if (shared && Utils::DecodedObjects::Find(key, output))
+        return true;
+
     mz_zip_reader_create_ptr reader{ mz_zip_reader_create() };
     mz_zip_reader_set_password(reader.value, password.c_str());
     mz_zip_reader_set_pattern(reader.value, (char*) entry.filename.data(), 0);
@@ -351,6 +382,8 @@ bool Info::Decompress(const BufferView& input, Buffer& output, uint32 index, con
     CHECK(mz_zip_reader_entry_save_buffer(reader.value, output.GetData(), (int32_t) entry.uncompressed_size) == MZ_OK, false, "");
 
     output.Resize(entry.uncompressed_size);
+    if (shared)
+        Utils::DecodedObjects::Add(key, output);
 
     return true;
 }
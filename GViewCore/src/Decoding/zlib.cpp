@@ -66,4 +66,182 @@ bool DecompressStream(const BufferView& input, Buffer& output, String& message,
 
     return true;
 }
+
+struct StreamInflaterContext {
+    z_stream stream;
+    bool initialized;
+    bool finished;
+
+    // block counting: the header of the next block starts with the unused bits of the last byte read by zlib
+    bool countBlocks;
+    uint8 lastByte;
+    bool headerPending;
+    uint32 headerBits;
+    uint32 headerBitsCount;
+    uint32 blockCount[4];
+};
+
+static void ResolveBlockHeader(StreamInflaterContext* ctx)
+{
+    if (!ctx->headerPending) {
+        return;
+    }
+    // BFINAL is the first bit of the header, BTYPE the next two
+    if (ctx->headerBitsCount < 3) {
+        if (ctx->stream.avail_in == 0) {
+            return;
+        }
+        ctx->headerBits |= ((uint32) ctx->stream.next_in[0]) << ctx->headerBitsCount;
+        ctx->headerBitsCount += 8;
+    }
+    ctx->blockCount[(ctx->headerBits >> 1) & 3]++;
+    ctx->headerPending = false;
+}
+
+static int InflateCountingBlocks(StreamInflaterContext* ctx)
+{
+    int ret = Z_OK;
+    do {
+        ResolveBlockHeader(ctx);
+
+        const auto availableIn = ctx->stream.avail_in;
+        ret                    = inflate(&ctx->stream, Z_BLOCK);
+        if (ctx->stream.avail_in < availableIn) {
+            ctx->lastByte = ctx->stream.next_in[-1];
+        }
+
+        // bit 7: stopped right before a block header, bit 6: the last block was already started
+        if (ret == Z_OK && (ctx->stream.data_type & 128) && !(ctx->stream.data_type & 64)) {
+            const uint32 unused  = ctx->stream.data_type & 7;
+            ctx->headerBits      = unused ? (ctx->lastByte >> (8 - unused)) : 0;
+            ctx->headerBitsCount = unused;
+            ctx->headerPending   = true;
+        }
+    } while (ret == Z_OK && ctx->stream.avail_out > 0 && ctx->stream.avail_in > 0);
+
+    ResolveBlockHeader(ctx);
+    return ret;
+}
+
+StreamInflater::StreamInflater() : context(nullptr)
+{
+}
+
+StreamInflater::~StreamInflater()
+{
+    auto ctx = reinterpret_cast<StreamInflaterContext*>(context);
+    if (ctx == nullptr) {
+        return;
+    }
+    if (ctx->initialized) {
+        inflateEnd(&ctx->stream);
+    }
+    delete ctx;
+    context = nullptr;
+}
+
+bool StreamInflater::Init(bool rawDeflate)
+{
+    // negative window bits select a raw deflate stream
+    const int windowBits = rawDeflate ? -MAX_WBITS : MAX_WBITS;
+
+    auto ctx = reinterpret_cast<StreamInflaterContext*>(context);
+    if (ctx == nullptr) {
+        ctx     = new StreamInflaterContext();
+        context = ctx;
+    } else if (ctx->initialized) {
+        // reuse the already allocated window
+        ctx->finished      = false;
+        ctx->headerPending = false;
+        memset(ctx->blockCount, 0, sizeof(ctx->blockCount));
+        CHECK(inflateReset2(&ctx->stream, windowBits) == Z_OK, false, "");
+        return true;
+    }
+
+    memset(&ctx->stream, Z_NULL, sizeof(ctx->stream));
+    ctx->finished      = false;
+    ctx->headerPending = false;
+    memset(ctx->blockCount, 0, sizeof(ctx->blockCount));
+
+    const auto ret = inflateInit2(&ctx->stream, windowBits);
+    CHECK(ret == Z_OK, false, "ZLIB error: %d!", ret);
+    ctx->initialized = true;
+
+    return true;
+}
+
+void StreamInflater::SetInput(const BufferView& input)
+{
+    auto ctx = reinterpret_cast<StreamInflaterContext*>(context);
+    if (ctx == nullptr || ctx->initialized == false) {
+        return;
+    }
+    ctx->stream.next_in  = const_cast<Bytef*>(input.GetData());
+    ctx->stream.avail_in = static_cast<uInt>(input.GetLength());
+}
+
+bool StreamInflater::Inflate(uint8* output, uint32 outputSize, uint32& written)
+{
+    written  = 0;
+    auto ctx = reinterpret_cast<StreamInflaterContext*>(context);
+    CHECK(ctx != nullptr && ctx->initialized, false, "Inflater was not initialized!");
+    CHECK(output != nullptr, false, "");
+
+    if (ctx->finished || outputSize == 0) {
+        return true;
+    }
+
+    ctx->stream.next_out  = reinterpret_cast<Bytef*>(output);
+    ctx->stream.avail_out = static_cast<uInt>(outputSize);
+
+    const auto ret = ctx->countBlocks ? InflateCountingBlocks(ctx) : inflate(&ctx->stream, Z_NO_FLUSH);
+    written        = outputSize - ctx->stream.avail_out;
+
+    if (ret == Z_STREAM_END) {
+        ctx->finished = true;
+        return true;
+    }
+    // Z_BUF_ERROR only means that no progress was possible (more input is required)
+    CHECK(ret == Z_OK || ret == Z_BUF_ERROR, false, "ZLIB error: %d (%s)!", ret, ctx->stream.msg ? ctx->stream.msg : "");
+
+    return true;
+}
+
+bool StreamInflater::NeedsInput() const
+{
+    auto ctx = reinterpret_cast<StreamInflaterContext*>(context);
+    return ctx != nullptr && ctx->stream.avail_in == 0;
+}
+
+bool StreamInflater::IsFinished() const
+{
+    auto ctx = reinterpret_cast<StreamInflaterContext*>(context);
+    return ctx != nullptr && ctx->finished;
+}
+
+uint64 StreamInflater::GetTotalIn() const
+{
+    auto ctx = reinterpret_cast<StreamInflaterContext*>(context);
+    return ctx != nullptr ? ctx->stream.total_in : 0;
+}
+
+uint64 StreamInflater::GetTotalOut() const
+{
+    auto ctx = reinterpret_cast<StreamInflaterContext*>(context);
+    return ctx != nullptr ? ctx->stream.total_out : 0;
+}
+
+void StreamInflater::SetBlockCounting(bool enabled)
+{
+    auto ctx = reinterpret_cast<StreamInflaterContext*>(context);
+    if (ctx != nullptr) {
+        ctx->countBlocks = enabled;
+    }
+}
+
+uint32 StreamInflater::GetBlockCount(DeflateBlockType type) const
+{
+    auto ctx = reinterpret_cast<StreamInflaterContext*>(context);
+    return ctx != nullptr ? ctx->blockCount[static_cast<uint8>(type) & 3] : 0;
+}
 } // namespace GView::ZLIB
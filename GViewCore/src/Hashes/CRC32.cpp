@@ -31,6 +31,57 @@ static const uint32 CRC32Table[] = {
     0x5d681b02L, 0x2a6f2b94L, 0xb40bbe37L, 0xc30c8ea1L, 0x5a05df1bL, 0x2d02ef8dL
 };
 
+// slice-by-8: CRC32Tables[k][i] is the CRC of byte `i` followed by `k` zero bytes, so 8 input bytes are
+// processed with 8 independent table lookups instead of a chain of 8 dependent ones
+struct CRC32SliceTables {
+    uint32 values[8][256];
+
+    CRC32SliceTables()
+    {
+        for (uint32 i = 0; i < 256; i++) {
+            values[0][i] = CRC32Table[i];
+        }
+        for (uint32 i = 0; i < 256; i++) {
+            for (uint32 k = 1; k < 8; k++) {
+                values[k][i] = (values[k - 1][i] >> 8) ^ CRC32Table[values[k - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+static const CRC32SliceTables CRC32Tables;
+
+// x^(2^n) mod P(x) for n = 0..31 - used to shift a CRC over a run of zero bytes
+struct CRC32PowerTable {
+    uint32 values[32];
+
+    static uint32 MultiplyModP(uint32 a, uint32 b)
+    {
+        uint32 m = 1U << 31;
+        uint32 p = 0;
+        while (true) {
+            if (a & m) {
+                p ^= b;
+                if ((a & (m - 1)) == 0) {
+                    break;
+                }
+            }
+            m >>= 1;
+            b = (b & 1) ? (b >> 1) ^ 0xEDB88320U : b >> 1;
+        }
+        return p;
+    }
+
+    CRC32PowerTable()
+    {
+        uint32 p = 1U << 30; // x^1
+        values[0] = p;
+        for (uint32 n = 1; n < 32; n++) {
+            values[n] = p = MultiplyModP(p, p);
+        }
+    }
+};
+static const CRC32PowerTable CRC32Powers;
+
 bool CRC32::Init(CRC32Type type)
 {
     this->type = type;
@@ -44,7 +95,20 @@ bool CRC32::Update(const unsigned char* input, uint32 length)
 {
     CHECK(input != nullptr, false, "");
     uint32 crc = value;
+    const auto& t = CRC32Tables.values;
 
+    // the 8 bytes block is read in little endian order (all supported platforms)
+    while (length >= 8)
+    {
+        uint32 lo, hi;
+        memcpy(&lo, input, sizeof(lo));
+        memcpy(&hi, input + 4, sizeof(hi));
+        lo ^= crc;
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^ t[3][hi & 0xFF] ^
+              t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        input += 8;
+        length -= 8;
+    }
     while (length--)
     {
         crc = CRC32Table[(crc & 0xff) ^ *input++] ^ (crc >> 8);
@@ -78,6 +142,18 @@ bool CRC32::Final(uint32& hash)
     return true;
 }
 
+uint32 CRC32::Combine(uint32 crc1, uint32 crc2, uint64 length2)
+{
+    // crc(A + B) = crc(A) * x^(8 * len(B)) mod P  xor  crc(B)
+    uint32 p = 1U << 31; // x^0
+    for (uint32 k = 3; length2; length2 >>= 1, k++)
+    {
+        if (length2 & 1)
+            p = CRC32PowerTable::MultiplyModP(CRC32Powers.values[k & 31], p);
+    }
+    return CRC32PowerTable::MultiplyModP(p, crc1) ^ crc2;
+}
+
 std::string_view CRC32::GetName(CRC32Type type)
 {
     if (type == CRC32Type::JAMCRC)
@@ -1,7 +1,9 @@
 #include "../include/GView.hpp"
 
 #include <string>
+#include <memory>
 #include <re2/re2.h>
+#include <re2/set.h>
 
 namespace GView::Regex
 {
@@ -55,4 +57,103 @@ bool Matcher::Match(BufferView buffer, uint64& start, uint64& end)
 
     return false;
 }
+
+struct SetContext {
+    RE2::Options options;
+    RE2::Set set;
+    std::vector<std::unique_ptr<RE2>> expressions; // the same expressions, used to find the offsets of the matches
+    bool compiled{ false };
+
+    SetContext(const RE2::Options& o) : options(o), set(o, RE2::UNANCHORED)
+    {
+    }
+};
+
+bool MatcherSet::Init(bool isCaseSensitive)
+{
+    CHECK(this->context == nullptr, false, "");
+
+    RE2::Options options;
+    options.set_case_sensitive(isCaseSensitive);
+    options.set_longest_match(false);
+    options.set_log_errors(false);
+
+    this->context = new SetContext(options);
+
+    return true;
+}
+
+MatcherSet::~MatcherSet()
+{
+    if (this->context != nullptr) {
+        delete reinterpret_cast<SetContext*>(this->context);
+    }
+}
+
+int32 MatcherSet::Add(std::string_view expression)
+{
+    auto ctx = reinterpret_cast<SetContext*>(this->context);
+    CHECK(ctx != nullptr, -1, "");
+    CHECK(ctx->compiled == false, -1, "");
+
+    absl::string_view asv{ expression.data(), expression.size() };
+    auto re = std::make_unique<RE2>(asv, ctx->options);
+    CHECK(re->ok(), -1, "");
+
+    const auto index = ctx->set.Add(asv, nullptr);
+    CHECK(index == static_cast<int32>(ctx->expressions.size()), -1, "");
+    ctx->expressions.push_back(std::move(re));
+
+    return index;
+}
+
+bool MatcherSet::Compile()
+{
+    auto ctx = reinterpret_cast<SetContext*>(this->context);
+    CHECK(ctx != nullptr, false, "");
+    CHECK(ctx->compiled == false, false, "");
+    CHECK(ctx->set.Compile(), false, "");
+    ctx->compiled = true;
+
+    return true;
+}
+
+bool MatcherSet::Match(BufferView buffer, std::vector<uint32>& expressions)
+{
+    auto ctx = reinterpret_cast<SetContext*>(this->context);
+    CHECK(ctx != nullptr, false, "");
+    CHECK(ctx->compiled, false, "");
+
+    absl::string_view sv{ reinterpret_cast<const char*>(buffer.GetData()), buffer.GetLength() };
+    std::vector<int> matched;
+    RE2::Set::ErrorInfo error{};
+    if (!ctx->set.Match(sv, &matched, &error)) {
+        // the automaton ran out of memory: the caller can not tell which expressions matched
+        CHECK(error.kind == RE2::Set::kNoError, false, "");
+        return true;
+    }
+    for (const auto index : matched) {
+        expressions.push_back(static_cast<uint32>(index));
+    }
+
+    return true;
+}
+
+bool MatcherSet::Find(uint32 expression, BufferView buffer, uint64 from, uint64& start, uint64& end)
+{
+    auto ctx = reinterpret_cast<SetContext*>(this->context);
+    CHECK(ctx != nullptr, false, "");
+    CHECK(expression < ctx->expressions.size(), false, "");
+    CHECK(from <= buffer.GetLength(), false, "");
+
+    absl::string_view sv{ reinterpret_cast<const char*>(buffer.GetData()), buffer.GetLength() };
+    re2::StringPiece result;
+    if (ctx->expressions[expression]->Match(sv, static_cast<size_t>(from), sv.size(), RE2::UNANCHORED, &result, 1)) {
+        start = result.data() - sv.data();
+        end   = start + result.size();
+        return true;
+    }
+
+    return false;
+}
 } // namespace GView::Regex
@@ -1,38 +1,915 @@
 #include "GView.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#ifdef BUILD_FOR_WINDOWS
+#    include <Windows.h>
+#    undef GetObject
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+#if defined(BUILD_FOR_UNIX) && __has_include(<linux/io_uring.h>)
+#    include <linux/io_uring.h>
+#    include <sys/syscall.h>
+#    ifdef IORING_FEAT_RW_CUR_POS
+#        define HAS_IO_URING
+#    endif
+#endif
+
 using namespace GView::Utils;
 
 constexpr uint32 MAX_CACHE_SIZE = 0x20000000U; // 16 M
+// DataObject::Write / Read take a 32 bits size, larger transfers are done in slices of this size
+constexpr uint32 MAX_TRANSFER_SIZE = 0x40000000U;
+// the cache memory is split in pages of this size (the minimum cache size is a multiple of it)
+constexpr uint32 CACHE_PAGE_SIZE   = 0x4000U;
+constexpr uint32 INVALID_PAGE_SLOT = 0xFFFFFFFFU;
+constexpr uint64 INVALID_PAGE      = 0xFFFFFFFFFFFFFFFFULL;
+
+// forward sequential scans are detected after this many consecutive requests
+constexpr uint32 SEQUENTIAL_REQUESTS_THRESHOLD = 3;
+// blocks read at once by the background reader (the size of the io_uring submission queue)
+constexpr uint32 MAX_READS_IN_FLIGHT = 8;
+
+struct ReadRequest
+{
+    uint64 offset;
+    uint8* buffer;
+    uint32 size;
+};
+
+// reads from the file (updated by the thread that owns the cache, the background reader and the ReadAt callers)
+struct IOCounters
+{
+    std::atomic<uint64> reads, failedReads, bytesRead;
+    std::atomic<uint64> latency[DataCache::LATENCY_BUCKETS];
+
+    IOCounters()
+    {
+        Reset();
+    }
+    void Reset()
+    {
+        reads       = 0;
+        failedReads = 0;
+        bytesRead   = 0;
+        for (auto& bucket : latency)
+            bucket = 0;
+    }
+    void Record(uint32 size, bool result, std::chrono::steady_clock::time_point start)
+    {
+        const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        const auto bucket   = std::min<uint32>((uint32) std::bit_width((uint64) std::max<int64>(duration, 0)), DataCache::LATENCY_BUCKETS - 1);
+        latency[bucket].fetch_add(1, std::memory_order_relaxed);
+        reads.fetch_add(1, std::memory_order_relaxed);
+        if (result)
+            bytesRead.fetch_add(size, std::memory_order_relaxed);
+        else
+            failedReads.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+// the requests are accounted only on the thread that owns the cache (ReadAt calls are counted only as reads)
+struct CacheStatistics
+{
+    IOCounters io;
+    std::vector<DataCache::Statistics::Subsystem> subsystems; // the first one holds the requests that were not tagged
+    uint32 current;
+    uint64 largestRequest;
+
+    CacheStatistics() : subsystems(1), current(0), largestRequest(0)
+    {
+    }
+    DataCache::Statistics::Subsystem& Request(uint64 size)
+    {
+        largestRequest  = std::max<>(largestRequest, size);
+        auto& subsystem = subsystems[current];
+        subsystem.requests++;
+        subsystem.requestedBytes += size;
+        return subsystem;
+    }
+    uint32 Find(std::string_view name)
+    {
+        // only a few subsystems use the same object
+        for (uint32 index = 1; index < subsystems.size(); index++)
+            if (subsystems[index].name == name)
+                return index;
+        subsystems.push_back({ std::string(name), 0, 0, 0, 0 });
+        return (uint32) (subsystems.size() - 1);
+    }
+    void Reset()
+    {
+        io.Reset();
+        largestRequest = 0;
+        for (auto& subsystem : subsystems)
+        {
+            subsystem.requests       = 0;
+            subsystem.requestedBytes = 0;
+            subsystem.hits           = 0;
+            subsystem.misses         = 0;
+        }
+    }
+};
+
+#ifdef HAS_IO_URING
+// minimal io_uring (raw system calls, the queues are shared with the kernel) used to keep a batch of reads in flight
+class IoRing
+{
+    int ringFd;
+    uint8* queues; // the submission and the completion queue share a single mapping (IORING_FEAT_SINGLE_MMAP)
+    size_t queuesSize;
+    io_uring_sqe* entries;
+    size_t entriesSize;
+    uint32 *sqHead, *sqTail, *sqMask, *sqArray;
+    uint32 *cqHead, *cqTail, *cqMask;
+    io_uring_cqe* completions;
+
+  public:
+    IoRing() : ringFd(-1), queues(nullptr), queuesSize(0), entries(nullptr), entriesSize(0)
+    {
+    }
+    ~IoRing()
+    {
+        if (entries)
+            munmap(entries, entriesSize);
+        if (queues)
+            munmap(queues, queuesSize);
+        if (ringFd >= 0)
+            close(ringFd);
+    }
+    // fails on kernels without io_uring (or where it is disabled) --> the caller keeps using pread
+    bool Init(uint32 count)
+    {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        ringFd = (int) syscall(__NR_io_uring_setup, count, &params);
+        if (ringFd < 0)
+            return false;
+        // IORING_OP_READ and a single mapping for both queues (Linux 5.6+)
+        if (((params.features & IORING_FEAT_SINGLE_MMAP) == 0) || ((params.features & IORING_FEAT_RW_CUR_POS) == 0) ||
+            ((params.features & IORING_FEAT_NODROP) == 0))
+            return false;
+
+        queuesSize = std::max<size_t>(
+              params.sq_off.array + params.sq_entries * sizeof(uint32), params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+        auto view = mmap(nullptr, queuesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+        if (view == MAP_FAILED)
+            return false;
+        queues      = reinterpret_cast<uint8*>(view);
+        entriesSize = params.sq_entries * sizeof(io_uring_sqe);
+        view        = mmap(nullptr, entriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+        if (view == MAP_FAILED)
+            return false;
+        entries = reinterpret_cast<io_uring_sqe*>(view);
+
+        sqHead      = reinterpret_cast<uint32*>(queues + params.sq_off.head);
+        sqTail      = reinterpret_cast<uint32*>(queues + params.sq_off.tail);
+        sqMask      = reinterpret_cast<uint32*>(queues + params.sq_off.ring_mask);
+        sqArray     = reinterpret_cast<uint32*>(queues + params.sq_off.array);
+        cqHead      = reinterpret_cast<uint32*>(queues + params.cq_off.head);
+        cqTail      = reinterpret_cast<uint32*>(queues + params.cq_off.tail);
+        cqMask      = reinterpret_cast<uint32*>(queues + params.cq_off.ring_mask);
+        completions = reinterpret_cast<io_uring_cqe*>(queues + params.cq_off.cqes);
+        return true;
+    }
+    // the caller never queues more than the number of entries the ring was created with
+    void Queue(int fd, uint64 offset, uint8* buffer, uint32 size, uint64 userData)
+    {
+        const auto tail  = *sqTail;
+        const auto index = tail & *sqMask;
+        auto& sqe        = entries[index];
+        memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode    = IORING_OP_READ;
+        sqe.fd        = fd;
+        sqe.off       = offset;
+        sqe.addr      = (uint64) buffer;
+        sqe.len       = size;
+        sqe.user_data = userData;
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+    }
+    // submits the queued reads and waits for at least one of them to complete
+    bool Submit(uint32 count)
+    {
+        for (;;)
+        {
+            const auto result = syscall(__NR_io_uring_enter, ringFd, count, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (result >= 0)
+                return true;
+            if ((errno != EINTR) && (errno != EAGAIN) && (errno != EBUSY))
+                return false;
+            // the entries that were not consumed are submitted again (a call that fails consumes none of them)
+        }
+    }
+    // waits for at least one of the submitted reads to complete
+    bool Wait()
+    {
+        for (;;)
+        {
+            const auto result = syscall(__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (result >= 0)
+                return true;
+            if ((errno != EINTR) && (errno != EAGAIN) && (errno != EBUSY))
+                return false;
+        }
+    }
+    // takes back the queued entries the kernel did not consume (there is no submission polling thread, so it consumes them only
+    // in Submit) and returns their user data
+    template <typename F>
+    void Withdraw(F&& onEntry)
+    {
+        const auto head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        const auto tail = *sqTail;
+        for (auto position = head; position != tail; position++)
+            onEntry(entries[sqArray[position & *sqMask]].user_data);
+        __atomic_store_n(sqTail, head, __ATOMIC_RELEASE);
+    }
+    bool NextCompletion(uint64& userData, int32& result)
+    {
+        const auto head = *cqHead;
+        if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE))
+            return false;
+        const auto& cqe = completions[head & *cqMask];
+        userData        = cqe.user_data;
+        result          = cqe.res;
+        __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+};
+#endif
+
+// reads the file through a handle owned by the cache: positional reads (pread / ReadFile with an offset) do not move a shared
+// file pointer, so unlike the DataObject ones they can be done from several threads at once
+class PositionalReader
+{
+#ifdef BUILD_FOR_WINDOWS
+    HANDLE file;
+#else
+    int fd;
+#endif
+#ifdef HAS_IO_URING
+    std::unique_ptr<IoRing> ring; // only the background reader submits batches
+#endif
+
+  public:
+    PositionalReader()
+    {
+#ifdef BUILD_FOR_WINDOWS
+        file = INVALID_HANDLE_VALUE;
+#else
+        fd = -1;
+#endif
+    }
+    ~PositionalReader()
+    {
+#ifdef BUILD_FOR_WINDOWS
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+#else
+        if (fd >= 0)
+            close(fd);
+#endif
+    }
+    // the file is opened again, so it has to be a regular file with the size of the cached object
+    bool Open(const std::filesystem::path& path, uint64 fileSize, bool batchedReads)
+    {
+#ifdef BUILD_FOR_WINDOWS
+        file = CreateFileW(
+              path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        CHECK(file != INVALID_HANDLE_VALUE, false, "Fail to open file (error: %u)", GetLastError());
+        LARGE_INTEGER size;
+        CHECK((GetFileType(file) == FILE_TYPE_DISK) && GetFileSizeEx(file, &size) && ((uint64) size.QuadPart == fileSize), false, "");
+#else
+        fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        CHECK(fd >= 0, false, "Fail to open file (errno: %d)", errno);
+        struct stat st;
+        CHECK((fstat(fd, &st) == 0) && S_ISREG(st.st_mode) && ((uint64) st.st_size == fileSize), false, "");
+#endif
+#ifdef HAS_IO_URING
+        if (batchedReads)
+        {
+            ring = std::make_unique<IoRing>();
+            if (ring->Init(MAX_READS_IN_FLIGHT) == false)
+                ring.reset();
+        }
+#endif
+        return true;
+    }
+    bool Read(uint64 offset, uint8* buffer, uint32 size)
+    {
+        while (size)
+        {
+#ifdef BUILD_FOR_WINDOWS
+            OVERLAPPED position = {};
+            position.Offset     = (DWORD) offset;
+            position.OffsetHigh = (DWORD) (offset >> 32);
+            DWORD count         = 0;
+            if ((!ReadFile(file, buffer, size, &count, &position)) || (count == 0))
+                return false;
+#else
+            const auto count = pread(fd, buffer, size, (off_t) offset);
+            if ((count < 0) && (errno == EINTR))
+                continue;
+            if (count <= 0)
+                return false;
+#endif
+            buffer += count;
+            offset += count;
+            size -= (uint32) count;
+        }
+        return true;
+    }
+    // onRead(index, result) is called as each request completes (with io_uring up to MAX_READS_IN_FLIGHT of them are read at once)
+    template <typename F>
+    void ReadBatch(std::span<const ReadRequest> requests, F&& onRead)
+    {
+        size_t next = 0;
+#ifdef HAS_IO_URING
+        if (ring)
+        {
+            std::vector<uint32> done(requests.size(), 0); // bytes read so far (reads can be short)
+            std::vector<bool> inRing(requests.size(), false);
+            std::vector<size_t> queue;
+            uint32 inFlight = 0, queued = 0;
+            auto reap = [&]() {
+                uint64 index;
+                int32 result;
+                while (ring->NextCompletion(index, result))
+                {
+                    inFlight--;
+                    inRing[index] = false;
+                    if ((result == -EINTR) || (result == -EAGAIN))
+                    {
+                        queue.push_back((size_t) index);
+                        continue;
+                    }
+                    if (result <= 0)
+                    {
+                        done[index] = 0xFFFFFFFFU; // already reported as failed
+                        onRead((size_t) index, false);
+                        continue;
+                    }
+                    done[index] += (uint32) result;
+                    if (done[index] < requests[index].size)
+                        queue.push_back((size_t) index);
+                    else
+                        onRead((size_t) index, true);
+                }
+            };
+            while ((next < requests.size()) || (inFlight > 0) || (!queue.empty()))
+            {
+                for (; (inFlight < MAX_READS_IN_FLIGHT) && ((!queue.empty()) || (next < requests.size())); inFlight++, queued++)
+                {
+                    size_t index;
+                    if (!queue.empty())
+                    {
+                        index = queue.back();
+                        queue.pop_back();
+                    }
+                    else
+                        index = next++;
+                    const auto& r = requests[index];
+                    ring->Queue(fd, r.offset + done[index], r.buffer + done[index], r.size - done[index], index);
+                    inRing[index] = true;
+                }
+                if (ring->Submit(queued) == false)
+                {
+                    // the ring is not used anymore: the entries that were not submitted are taken back and the reads that are in
+                    // flight are drained, as the kernel writes in the same buffers that are read below with pread
+                    ring->Withdraw([&](uint64 index) {
+                        inFlight--;
+                        inRing[index] = false;
+                    });
+                    while ((inFlight > 0) && ring->Wait())
+                        reap();
+                    if (inFlight > 0)
+                    {
+                        // the reads can not be waited for: the ring is left open (closing it does not wait for them either)
+                        // and their requests are reported as failed instead of being read again
+                        (void) ring.release();
+                        for (size_t index = 0; index < requests.size(); index++)
+                            if (inRing[index])
+                            {
+                                done[index] = 0xFFFFFFFFU;
+                                onRead(index, false);
+                            }
+                    }
+                    ring.reset();
+                    // whatever is left (including the rest of the short reads) is read with pread
+                    for (size_t index = 0; index < requests.size(); index++)
+                    {
+                        const auto& r = requests[index];
+                        if (done[index] < r.size)
+                            onRead(index, Read(r.offset + done[index], r.buffer + done[index], r.size - done[index]));
+                    }
+                    return;
+                }
+                queued = 0;
+                reap();
+            }
+            return;
+        }
+#endif
+        for (; next < requests.size(); next++)
+            onRead(next, Read(requests[next].offset, requests[next].buffer, requests[next].size));
+    }
+};
+
+// where the missing data is read from: the DataObject (reads are not positional - SetCurrentPos + Read - so they are
+// serialized) or, after DataCache::OpenReader, a reader with its own handle
+struct FileSource
+{
+    AppCUI::OS::DataObject* object;
+    std::mutex lock;
+    std::unique_ptr<PositionalReader> positional;
+    IOCounters& io;
+
+    FileSource(AppCUI::OS::DataObject* _object, IOCounters& _io) : object(_object), io(_io)
+    {
+    }
+    bool Read(uint64 offset, uint8* buffer, uint32 size)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        bool result;
+        if (positional)
+        {
+            result = positional->Read(offset, buffer, size);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            result = object->SetCurrentPos(offset) && object->Read(buffer, size);
+        }
+        io.Record(size, result, start);
+        return result;
+    }
+    template <typename F>
+    void ReadBatch(std::span<const ReadRequest> requests, F&& onRead)
+    {
+        if (positional)
+        {
+            // the latency of a read includes the time it waited for the other reads of the batch to be submitted
+            const auto start = std::chrono::steady_clock::now();
+            positional->ReadBatch(requests, [this, &requests, &onRead, start](size_t index, bool result) {
+                io.Record(requests[index].size, result, start);
+                onRead(index, result);
+            });
+            return;
+        }
+        for (size_t index = 0; index < requests.size(); index++)
+            onRead(index, Read(requests[index].offset, requests[index].buffer, requests[index].size));
+    }
+};
+
+// reads data on a worker thread: the windows that follow a sequential scan (one is consumed while the other one is read)
+// and the ranges announced with DataCache::Prefetch
+class BackgroundReader
+{
+    enum class BlockState : uint8
+    {
+        Pending,
+        Reading,
+        Ready,
+        Failed
+    };
+    struct Block
+    {
+        std::vector<uint8> data;
+        uint64 start, end;
+        uint64 consumed; // prefetched blocks are released once all their bytes were copied
+        BlockState state;
+        bool readAhead;
+    };
+    FileSource& file;
+    uint32 windowSize;
+    uint64 prefetchBudget, prefetchSize;
+    // only the worker changes the state of a block that is read, blocks are added and removed only by the thread that owns the cache
+    std::list<Block> blocks;
+    std::mutex lock;
+    std::condition_variable changed;
+    std::thread worker;
+    bool stop;
+
+    void Run()
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        Block* batch[MAX_READS_IN_FLIGHT];
+        ReadRequest requests[MAX_READS_IN_FLIGHT];
+        while (!stop)
+        {
+            // the pending blocks are read together (a block that is read is never removed)
+            uint32 count = 0;
+            for (auto& block : blocks)
+                if ((block.state == BlockState::Pending) && (count < MAX_READS_IN_FLIGHT))
+                {
+                    block.state     = BlockState::Reading;
+                    requests[count] = { block.start, block.data.data(), (uint32) (block.end - block.start) };
+                    batch[count++]  = &block;
+                }
+            if (count == 0)
+            {
+                changed.wait(guard);
+                continue;
+            }
+            guard.unlock();
+            file.ReadBatch(std::span<const ReadRequest>(requests, count), [this, &batch](size_t index, bool result) {
+                std::lock_guard<std::mutex> completed(lock);
+                batch[index]->state = result ? BlockState::Ready : BlockState::Failed;
+                changed.notify_all();
+            });
+            guard.lock();
+        }
+    }
+    bool IsAhead(const Block& b, uint64 position) const
+    {
+        return (b.state != BlockState::Failed) && (b.end > position) && (b.start <= position + 2ULL * windowSize);
+    }
+    void Release(std::list<Block>::iterator it)
+    {
+        if (!it->readAhead)
+            prefetchSize -= it->end - it->start;
+        blocks.erase(it);
+    }
+
+  public:
+    BackgroundReader(FileSource& _file, uint32 _windowSize, uint32 _prefetchBudget)
+        : file(_file), windowSize(_windowSize), prefetchBudget(_prefetchBudget), prefetchSize(0), stop(false)
+    {
+        worker = std::thread(&BackgroundReader::Run, this);
+    }
+    ~BackgroundReader()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stop = true;
+            changed.notify_all();
+        }
+        worker.join();
+    }
+    // schedules the read ahead windows that are not needed anymore right after the ones that are still ahead of position
+    void Advance(uint64 position, uint64 fileSize)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        uint32 windows = 0;
+        auto next      = position & ~((uint64) CACHE_PAGE_SIZE - 1);
+        for (auto& b : blocks)
+            if (b.readAhead)
+            {
+                windows++;
+                if (IsAhead(b, position))
+                    next = std::max<>(next, b.end);
+            }
+        for (; windows < 2; windows++)
+            blocks.push_back({ std::vector<uint8>(windowSize), 0, 0, 0, BlockState::Failed, true });
+        for (auto& b : blocks)
+        {
+            if ((!b.readAhead) || (next >= fileSize) || (b.state == BlockState::Pending) || (b.state == BlockState::Reading) || IsAhead(b, position))
+                continue;
+            b.start = next;
+            b.end   = std::min<uint64>(next + windowSize, fileSize);
+            b.state = BlockState::Pending;
+            next    = b.end;
+        }
+        changed.notify_all();
+    }
+    // page aligned runs (sorted, without the pages that are already cached) that are read in the background
+    void Prefetch(const std::vector<std::pair<uint64, uint64>>& runs)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (auto it = blocks.begin(); it != blocks.end();)
+        {
+            auto current = it++;
+            if ((!current->readAhead) && (current->state == BlockState::Failed))
+                Release(current);
+        }
+        for (auto [start, end] : runs)
+        {
+            // the most recent requests are more relevant --> the oldest prefetched blocks that were already read make room for them
+            for (auto it = blocks.begin(); (it != blocks.end()) && (prefetchSize + (end - start) > prefetchBudget);)
+            {
+                auto current = it++;
+                if ((!current->readAhead) && (current->state == BlockState::Ready))
+                    Release(current);
+            }
+            end = std::min<uint64>(end, start + (prefetchBudget - std::min<>(prefetchSize, prefetchBudget)));
+            // large runs are split so that the first bytes can be used before the entire run is read
+            for (; start < end; start += windowSize)
+            {
+                const auto blockEnd = std::min<uint64>(start + windowSize, end);
+                bool covered        = false;
+                for (const auto& b : blocks)
+                    covered |= (b.state != BlockState::Failed) && (b.start <= start) && (b.end >= blockEnd);
+                if (covered)
+                    continue;
+                blocks.push_back({ std::vector<uint8>(blockEnd - start), start, blockEnd, 0, BlockState::Pending, false });
+                prefetchSize += blockEnd - start;
+            }
+        }
+        changed.notify_all();
+    }
+    // copies [offset, offset+size) from the blocks (waiting for them if they are still read) or from the file
+    bool Read(uint64 offset, uint8* buffer, uint32 size)
+    {
+        while (size)
+        {
+            auto found        = blocks.end();
+            auto fileReadSize = size;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                for (auto it = blocks.begin(); it != blocks.end(); it++)
+                {
+                    if ((it->state == BlockState::Failed) || (it->end <= offset))
+                        continue;
+                    if (it->start <= offset)
+                        found = it;
+                    else if (it->start < offset + fileReadSize)
+                        fileReadSize = (uint32) (it->start - offset); // only the data up to this block is read from the file
+                }
+                if (found != blocks.end())
+                {
+                    const auto& b = *found;
+                    changed.wait(guard, [&b] { return (b.state != BlockState::Pending) && (b.state != BlockState::Reading); });
+                    if (b.state != BlockState::Ready)
+                    {
+                        // the data of the block is read from the file
+                        fileReadSize = (uint32) std::min<uint64>(size, b.end - offset);
+                        found        = blocks.end();
+                    }
+                }
+            }
+            uint32 count;
+            if (found != blocks.end())
+            {
+                // a ready block is changed only by this thread --> the data can be copied without the lock
+                count = (uint32) std::min<uint64>(size, found->end - offset);
+                memcpy(buffer, found->data.data() + (offset - found->start), count);
+                if (!found->readAhead)
+                {
+                    found->consumed += count;
+                    if (found->consumed >= found->end - found->start)
+                    {
+                        std::lock_guard<std::mutex> guard(lock);
+                        Release(found);
+                    }
+                }
+            }
+            else
+            {
+                count = fileReadSize;
+                if (file.Read(offset, buffer, count) == false)
+                    return false;
+            }
+            buffer += count;
+            offset += count;
+            size -= count;
+        }
+        return true;
+    }
+};
+
+struct CachedPages
+{
+    struct Slot
+    {
+        uint64 page; // offset / CACHE_PAGE_SIZE
+        uint32 size; // less than CACHE_PAGE_SIZE only for the last page of the file
+        uint32 prev, next;
+    };
+    std::vector<Slot> slots;
+    std::unordered_map<uint64, uint32> index; // page -> slot
+    uint32 mostRecent, leastRecent, used;
+    // requests that span over multiple pages are copied in this window ([stitchStart, stitchEnd) of the file): requests that
+    // fit after the data it already holds extend it, so the views returned for them stay valid together
+    uint8* stitch;
+    uint32 stitchSize;
+    uint64 stitchStart, stitchEnd;
+    // shared with ReadAt (other threads) and the background reader
+    FileSource file;
+    // access pattern detection (the worker is created on the first sequential scan or prefetch request)
+    DataCache::AccessPattern pattern;
+    uint64 lastOffset, lastEnd;
+    uint32 sequentialRequests;
+    std::unique_ptr<BackgroundReader> reader;
+
+    CachedPages(AppCUI::OS::DataObject* fileObj, uint32 count, uint8* _stitch, uint32 _stitchSize, IOCounters& io)
+        : slots(count), mostRecent(INVALID_PAGE_SLOT), leastRecent(INVALID_PAGE_SLOT), used(0), stitch(_stitch), stitchSize(_stitchSize), stitchStart(0),
+          stitchEnd(0), file(fileObj, io), pattern(DataCache::AccessPattern::Auto), lastOffset(0), lastEnd(0), sequentialRequests(0)
+    {
+        index.reserve(count);
+    }
+    uint32 Find(uint64 page) const
+    {
+        auto it = index.find(page);
+        return it == index.end() ? INVALID_PAGE_SLOT : it->second;
+    }
+    void Unlink(uint32 slot)
+    {
+        auto& s = slots[slot];
+        if (s.prev != INVALID_PAGE_SLOT)
+            slots[s.prev].next = s.next;
+        else
+            mostRecent = s.next;
+        if (s.next != INVALID_PAGE_SLOT)
+            slots[s.next].prev = s.prev;
+        else
+            leastRecent = s.prev;
+    }
+    void LinkFirst(uint32 slot)
+    {
+        auto& s = slots[slot];
+        s.prev  = INVALID_PAGE_SLOT;
+        s.next  = mostRecent;
+        if (mostRecent != INVALID_PAGE_SLOT)
+            slots[mostRecent].prev = slot;
+        mostRecent = slot;
+        if (leastRecent == INVALID_PAGE_SLOT)
+            leastRecent = slot;
+    }
+    void LinkLast(uint32 slot)
+    {
+        auto& s = slots[slot];
+        s.prev  = leastRecent;
+        s.next  = INVALID_PAGE_SLOT;
+        if (leastRecent != INVALID_PAGE_SLOT)
+            slots[leastRecent].next = slot;
+        leastRecent = slot;
+        if (mostRecent == INVALID_PAGE_SLOT)
+            mostRecent = slot;
+    }
+    void Touch(uint32 slot)
+    {
+        if (slot == mostRecent)
+            return;
+        Unlink(slot);
+        LinkFirst(slot);
+    }
+    // returns a slot for a new page (an unused one or the least recently used one)
+    uint32 Acquire(uint64 page, uint32 size)
+    {
+        uint32 slot;
+        if (used < slots.size())
+        {
+            slot = used++;
+        }
+        else
+        {
+            slot = leastRecent;
+            Unlink(slot);
+            index.erase(slots[slot].page);
+        }
+        slots[slot].page = page;
+        slots[slot].size = size;
+        index[page]      = slot;
+        LinkFirst(slot);
+        return slot;
+    }
+    // the slot of a page that could not be read holds no page anymore and is the next one to be reused
+    void Release(uint32 slot)
+    {
+        Unlink(slot);
+        index.erase(slots[slot].page);
+        slots[slot].page = INVALID_PAGE;
+        slots[slot].size = 0;
+        LinkLast(slot);
+    }
+    bool IsSequential(uint64 offset, uint64 end)
+    {
+        if ((offset > lastOffset) && (offset <= lastEnd))
+            sequentialRequests++;
+        else if (offset != lastOffset)
+            sequentialRequests = 0;
+        lastOffset = offset;
+        lastEnd    = end;
+        if (pattern == DataCache::AccessPattern::Auto)
+            return sequentialRequests >= SEQUENTIAL_REQUESTS_THRESHOLD;
+        return pattern == DataCache::AccessPattern::Sequential;
+    }
+    // the worker gets as much memory as the cached pages: two read ahead windows of 1/4 of it and the rest for prefetching
+    BackgroundReader* GetReader()
+    {
+        if (reader == nullptr)
+        {
+            const auto pagesSize = (uint32) slots.size() * CACHE_PAGE_SIZE;
+            reader               = std::make_unique<BackgroundReader>(file, pagesSize >> 2, pagesSize >> 1);
+        }
+        return reader.get();
+    }
+    bool Read(uint64 offset, uint8* buffer, uint32 size)
+    {
+        if (reader)
+            return reader->Read(offset, buffer, size);
+        return file.Read(offset, buffer, size);
+    }
+    // copies [from, to) of the file at its place in the stitch window: the cached pages are copied and the missing ones are read
+    // straight in the window (and kept, unless the request is a large, scan like one that would evict most of the cached pages)
+    bool FillWindow(uint64 from, uint64 to, uint8* memory, uint64 fileSize, uint64& hits, uint64& misses)
+    {
+        const bool keepPages = (to - from) <= (uint64) slots.size() * CACHE_PAGE_SIZE / 2;
+        for (auto position = from; position < to;)
+        {
+            const auto page = position / CACHE_PAGE_SIZE;
+            auto slot       = Find(page);
+            if (slot != INVALID_PAGE_SLOT)
+            {
+                const auto pageEnd = std::min<uint64>((page + 1) * CACHE_PAGE_SIZE, to);
+                hits++;
+                Touch(slot);
+                memcpy(stitch + (position - stitchStart), memory + (uint64) slot * CACHE_PAGE_SIZE + (position % CACHE_PAGE_SIZE), (size_t) (pageEnd - position));
+                position = pageEnd;
+                continue;
+            }
+            // consecutive missing pages are read at once
+            auto next = page + 1;
+            while ((next * CACHE_PAGE_SIZE < to) && (Find(next) == INVALID_PAGE_SLOT))
+                next++;
+            misses += next - page;
+            const auto readEnd = std::min<uint64>(next * CACHE_PAGE_SIZE, to);
+            if (Read(position, stitch + (position - stitchStart), (uint32) (readEnd - position)) == false)
+                return false;
+            // only the pages that were read entirely are kept
+            for (auto p = page; keepPages && (p < next); p++)
+            {
+                const auto pageStart = p * CACHE_PAGE_SIZE;
+                const auto size      = (uint32) std::min<uint64>(CACHE_PAGE_SIZE, fileSize - pageStart);
+                if ((pageStart < position) || (pageStart + size > readEnd))
+                    continue;
+                slot = Acquire(p, size);
+                memcpy(memory + (uint64) slot * CACHE_PAGE_SIZE, stitch + (pageStart - stitchStart), size);
+            }
+            position = readEnd;
+        }
+        return true;
+    }
+};
+
+static void UnmapFile(const uint8* data, void* handle, uint64 size)
+{
+#ifdef BUILD_FOR_WINDOWS
+    UnmapViewOfFile(data);
+    CloseHandle(reinterpret_cast<HANDLE>(handle));
+#else
+    munmap(const_cast<uint8*>(data), (size_t) size);
+#endif
+}
 
 DataCache::DataCache()
 {
-    this->fileObj    = nullptr;
-    this->cache      = nullptr;
-    this->cacheSize  = 0;
-    this->start      = 0;
-    this->end        = 0;
-    this->fileSize   = 0;
-    this->currentPos = 0;
+    this->fileObj       = nullptr;
+    this->cache         = nullptr;
+    this->cacheSize     = 0;
+    this->pages         = nullptr;
+    this->hits          = 0;
+    this->misses        = 0;
+    this->fileSize      = 0;
+    this->currentPos    = 0;
+    this->mappedData    = nullptr;
+    this->mappingHandle = nullptr;
+    this->statistics    = nullptr;
 }
 DataCache::DataCache(DataCache&& obj)
 {
-    fileObj        = obj.fileObj;
-    fileSize       = obj.fileSize;
-    start          = obj.start;
-    end            = obj.end;
-    currentPos     = obj.currentPos;
-    cache          = obj.cache;
-    cacheSize      = obj.cacheSize;
-    obj.fileObj    = nullptr;
-    obj.fileSize   = 0;
-    obj.start      = 0;
-    obj.end        = 0;
-    obj.currentPos = 0;
-    obj.cache      = nullptr;
-    obj.cacheSize  = 0;
+    fileObj           = obj.fileObj;
+    fileSize          = obj.fileSize;
+    currentPos        = obj.currentPos;
+    cache             = obj.cache;
+    cacheSize         = obj.cacheSize;
+    pages             = obj.pages;
+    hits              = obj.hits;
+    misses            = obj.misses;
+    mappedData        = obj.mappedData;
+    mappingHandle     = obj.mappingHandle;
+    statistics        = obj.statistics;
+    obj.fileObj       = nullptr;
+    obj.fileSize      = 0;
+    obj.currentPos    = 0;
+    obj.cache         = nullptr;
+    obj.cacheSize     = 0;
+    obj.pages         = nullptr;
+    obj.hits          = 0;
+    obj.misses        = 0;
+    obj.mappedData    = nullptr;
+    obj.mappingHandle = nullptr;
+    obj.statistics    = nullptr;
 }
 DataCache::~DataCache()
 {
+    // the read ahead worker (if any) uses the file object
+    delete reinterpret_cast<CachedPages*>(this->pages);
+    this->pages = nullptr;
+    if (this->mappedData)
+        UnmapFile(this->mappedData, this->mappingHandle, this->fileSize);
+    this->mappedData    = nullptr;
+    this->mappingHandle = nullptr;
     if (this->fileObj)
     {
         this->fileObj->Close();
@@ -42,6 +919,8 @@ DataCache::~DataCache()
     if (this->cache)
         delete[] this->cache;
     this->cache = nullptr;
+    delete reinterpret_cast<CacheStatistics*>(this->statistics);
+    this->statistics = nullptr;
 }
 
 bool DataCache::Init(std::unique_ptr<AppCUI::OS::DataObject> file, uint32 _cacheSize)
@@ -49,97 +928,334 @@ bool DataCache::Init(std::unique_ptr<AppCUI::OS::DataObject> file, uint32 _cache
     CHECK(this->cacheSize == 0, false, "Cache object already initialized !");
     this->fileObj = file.release(); // take ownership of the pointer
     CHECK(this->fileObj, false, "Expecting a valid file object poiner !");
-    _cacheSize = (_cacheSize | 0xFFFF) + 1; // a minimum of 64 K for cache
+    // rounded up to a multiple of 64 K (a minimum of 64 K for cache): a cache initialized with the size of another one has the
+    // same size
+    _cacheSize = (std::max<uint32>(_cacheSize, 1) + 0xFFFF) & ~0xFFFFu;
     if (_cacheSize == 0)
         _cacheSize = MAX_CACHE_SIZE;
     _cacheSize     = std::min(_cacheSize, MAX_CACHE_SIZE);
     this->fileSize = fileObj->GetSize();
 
-    this->cache = new uint8[_cacheSize];
-    CHECK(this->cache, false, "Fail to allocate: %u bytes", _cacheSize);
-    this->cacheSize = _cacheSize;
-    this->start     = 0;
-    this->end       = 0;
+    // the window where the requests that span over multiple pages are stitched has the configured size (it is the largest
+    // request that can be served, reported as the cache size). The cached pages (half of it) are allocated on top of the
+    // window and the background reader (read ahead and prefetch) uses the same amount again once it is started
+    const auto windowSize = _cacheSize;
+    const auto pagesSize  = _cacheSize >> 1;
+    this->cache           = new uint8[pagesSize + windowSize];
+    CHECK(this->cache, false, "Fail to allocate: %u bytes", pagesSize + windowSize);
+    this->statistics = new CacheStatistics();
+    this->pages      = new CachedPages(
+          this->fileObj, pagesSize / CACHE_PAGE_SIZE, this->cache + pagesSize, windowSize, reinterpret_cast<CacheStatistics*>(this->statistics)->io);
+    this->cacheSize = windowSize;
+    this->hits      = 0;
+    this->misses    = 0;
 
     return true;
 }
+bool DataCache::MapFile(const std::filesystem::path& path)
+{
+    CHECK(this->fileObj, false, "Cache object was not initialized !");
+    CHECK(this->mappedData == nullptr, false, "File is already mapped !");
+    // empty files can not be mapped and on 32 bits systems the file has to fit in the address space
+    if ((this->fileSize == 0) || (this->fileSize > (uint64) SIZE_MAX))
+        return false;
+
+    const uint8* data = nullptr;
+    void* handle      = nullptr;
+#ifdef BUILD_FOR_WINDOWS
+    auto file = CreateFileW(
+          path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    CHECK(file != INVALID_HANDLE_VALUE, false, "Fail to open file for mapping (error: %u)", GetLastError());
+    LARGE_INTEGER size;
+    if ((GetFileType(file) != FILE_TYPE_DISK) || (!GetFileSizeEx(file, &size)) || ((uint64) size.QuadPart != this->fileSize))
+    {
+        CloseHandle(file);
+        return false;
+    }
+    // the mapping object keeps a reference to the file
+    auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    CHECK(mapping, false, "Fail to create a file mapping (error: %u)", GetLastError());
+    data = reinterpret_cast<const uint8*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data)
+    {
+        CloseHandle(mapping);
+        RETURNERROR(false, "Fail to map %llu bytes (error: %u)", this->fileSize, GetLastError());
+    }
+    handle = mapping;
+#else
+    auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    CHECK(fd >= 0, false, "Fail to open file for mapping (errno: %d)", errno);
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || (!S_ISREG(st.st_mode)) || ((uint64) st.st_size != this->fileSize))
+    {
+        close(fd);
+        return false;
+    }
+    // the mapping keeps a reference to the file
+    auto view = mmap(nullptr, (size_t) this->fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    CHECK(view != MAP_FAILED, false, "Fail to map %llu bytes (errno: %d)", this->fileSize, errno);
+    data = reinterpret_cast<const uint8*>(view);
+#endif
+
+    this->mappedData    = data;
+    this->mappingHandle = handle;
+    // the cached pages are not used anymore (cacheSize is kept as it is the preferred read size for callers)
+    if (this->cache)
+        delete[] this->cache;
+    this->cache = nullptr;
+    delete reinterpret_cast<CachedPages*>(this->pages);
+    this->pages = nullptr;
+
+    return true;
+}
+bool DataCache::OpenReader(const std::filesystem::path& path, bool batchedReads)
+{
+    CHECK(this->fileObj, false, "Cache object was not initialized !");
+    // a mapped file is never read
+    if (this->mappedData)
+        return true;
+
+    auto reader = std::make_unique<PositionalReader>();
+    if (reader->Open(path, this->fileSize, batchedReads) == false)
+        return false;
+    auto pages = reinterpret_cast<CachedPages*>(this->pages);
+    // the worker (if any) reads through the current source
+    pages->reader.reset();
+    pages->file.positional = std::move(reader);
+    return true;
+}
 BufferView DataCache::Get(uint64 offset, uint32 requestedSize, bool failIfRequestedSizeCanNotBeRead)
 {
     CHECK(this->fileObj, BufferView(), "File was not properly initialized !");
     CHECK(requestedSize > 0, BufferView(), "'requestedSize' has to be bigger than 0 ");
 
-    if (offset >= this->start)
+    // request outside file
+    if (offset >= this->fileSize)
+        return BufferView();
+    if (offset + requestedSize > this->fileSize)
+    {
+        if (failIfRequestedSizeCanNotBeRead)
+            return BufferView();
+        requestedSize = (uint32) (this->fileSize - offset);
+    }
+    auto& subsystem = reinterpret_cast<CacheStatistics*>(this->statistics)->Request(requestedSize);
+
+    if (this->mappedData)
+    {
+        // zero copy: the view points straight into the mapping
+        this->currentPos = offset + requestedSize;
+        return BufferView(this->mappedData + offset, requestedSize);
+    }
+
+    // no more than cacheSize bytes are returned at once
+    if (requestedSize > this->cacheSize)
+    {
+        if (failIfRequestedSizeCanNotBeRead)
+            return BufferView();
+        requestedSize = this->cacheSize;
+    }
+
+    auto pages           = reinterpret_cast<CachedPages*>(this->pages);
+    const auto firstPage = offset / CACHE_PAGE_SIZE;
+    const auto lastPage  = (offset + requestedSize - 1) / CACHE_PAGE_SIZE;
+    const auto pageStart = firstPage * CACHE_PAGE_SIZE;
+    const bool readAhead = pages->IsSequential(offset, offset + requestedSize);
+
+    if (firstPage == lastPage)
     {
-        // data is cached --> return from here
-        if ((offset + requestedSize) <= this->end)
+        // the view points straight into the page
+        auto slot = pages->Find(firstPage);
+        if (slot != INVALID_PAGE_SLOT)
         {
-            this->currentPos = offset + requestedSize;
-            return BufferView(&this->cache[offset - this->start], requestedSize);
+            this->hits++;
+            subsystem.hits++;
+            pages->Touch(slot);
         }
-        if (this->end == this->fileSize)
+        else
         {
-            // data is not cache (and we are at the end of the file with the case)
-            if (failIfRequestedSizeCanNotBeRead)
+            this->misses++;
+            subsystem.misses++;
+            const auto size = (uint32) std::min<uint64>(CACHE_PAGE_SIZE, this->fileSize - pageStart);
+            slot            = pages->Acquire(firstPage, size);
+            if (pages->Read(pageStart, this->cache + (uint64) slot * CACHE_PAGE_SIZE, size) == false)
+            {
+                pages->Release(slot);
                 return BufferView();
-            this->currentPos = this->fileSize;
-            return BufferView(&this->cache[offset - this->start], (uint32) (this->end - offset));
+            }
         }
+        this->currentPos = offset + requestedSize;
+        if (readAhead)
+            pages->GetReader()->Advance(this->currentPos, this->fileSize);
+        return BufferView(this->cache + (uint64) slot * CACHE_PAGE_SIZE + (offset - pageStart), requestedSize);
     }
-    // request outside file
-    if (offset >= this->fileSize)
-        return BufferView();
-    // data is not available in cache ==> read it
-    uint64 _start, _end;
-    if (this->fileSize <= this->cacheSize)
+
+    // the request spans over multiple pages --> they are stitched together in the window
+    const auto end = offset + requestedSize;
+    if ((offset < pages->stitchStart) || (end > pages->stitchEnd))
     {
-        // read everything
-        _start = 0;
-        _end   = this->fileSize;
+        // the window is extended when the request fits after the data it holds, otherwise it is filled again from the first
+        // page of the request (or from the offset, for requests that would not fit from the start of their page)
+        if ((pages->stitchStart == pages->stitchEnd) || (offset < pages->stitchStart) || (end - pages->stitchStart > pages->stitchSize))
+        {
+            pages->stitchStart = (end - pageStart <= pages->stitchSize) ? pageStart : offset;
+            pages->stitchEnd   = pages->stitchStart;
+        }
+        const auto from = pages->stitchEnd;
+        const auto to   = std::min<uint64>(std::min<uint64>((lastPage + 1) * CACHE_PAGE_SIZE, this->fileSize), pages->stitchStart + pages->stitchSize);
+        uint64 pagesHit = 0, pagesMissed = 0;
+        const auto result = pages->FillWindow(from, to, this->cache, this->fileSize, pagesHit, pagesMissed);
+        this->hits += pagesHit;
+        this->misses += pagesMissed;
+        subsystem.hits += pagesHit;
+        subsystem.misses += pagesMissed;
+        if (result == false)
+            return BufferView();
+        pages->stitchEnd = to;
     }
     else
     {
-        // compute the new buffer to read
-        auto sz = requestedSize;
-        if ((offset + sz) > this->fileSize)
-            sz = (uint32) (this->fileSize - offset);
-        if (sz > this->cacheSize)
-            sz = this->cacheSize;
-        auto diff = this->cacheSize - sz;
-        if (diff <= offset)
-            _start = offset - diff;
-        else
-            _start = 0;
-        _end = _start + this->cacheSize;
-        if (_end > this->fileSize)
-            _end = this->fileSize;
+        this->hits += lastPage - firstPage + 1;
+        subsystem.hits += lastPage - firstPage + 1;
     }
-    // read new data in cache
-    if (this->fileObj->SetCurrentPos(_start) == false)
-        return BufferView();
-    if (this->fileObj->Read(this->cache, (uint32) (_end - _start)) == false)
+    this->currentPos = end;
+    // the next window is read while the caller processes this one
+    if (readAhead)
+        pages->GetReader()->Advance(this->currentPos, this->fileSize);
+    return BufferView(pages->stitch + (offset - pages->stitchStart), requestedSize);
+}
+void DataCache::Hint(AccessPattern pattern)
+{
+    if (this->mappedData)
     {
-        this->start = 0;
-        this->end   = 0;
-        return BufferView();
+        // the kernel does the read ahead for mapped files
+#ifndef BUILD_FOR_WINDOWS
+        const int advice = pattern == AccessPattern::Sequential ? MADV_SEQUENTIAL : (pattern == AccessPattern::Random ? MADV_RANDOM : MADV_NORMAL);
+        madvise(const_cast<uint8*>(this->mappedData), (size_t) this->fileSize, advice);
+#endif
+        return;
     }
-    // return new pointer
-    this->start = _start;
-    this->end   = _end;
-    if ((offset + requestedSize) <= this->end)
+    auto pages = reinterpret_cast<CachedPages*>(this->pages);
+    if (pages)
     {
-        this->currentPos = offset + requestedSize;
-        return BufferView(&this->cache[offset - this->start], requestedSize);
+        pages->pattern            = pattern;
+        pages->sequentialRequests = 0;
     }
-    // the entire data is not in our cache
-    if (failIfRequestedSizeCanNotBeRead)
-        return BufferView();
-    if (this->end == this->fileSize)
+}
+bool DataCache::Prefetch(std::span<const Range> ranges)
+{
+    CHECK(this->fileObj, false, "File was not properly initialized !");
+
+    if (this->mappedData)
+    {
+        // the kernel loads the pages of the mapping
+        for (const auto& r : ranges)
+        {
+            if ((r.size == 0) || (r.offset >= this->fileSize))
+                continue;
+            const auto start = r.offset & ~((uint64) CACHE_PAGE_SIZE - 1);
+            const auto size  = (size_t) (std::min<uint64>(r.offset + r.size, this->fileSize) - start);
+#ifdef BUILD_FOR_WINDOWS
+            WIN32_MEMORY_RANGE_ENTRY entry = { const_cast<uint8*>(this->mappedData + start), size };
+            PrefetchVirtualMemory(GetCurrentProcess(), 1, &entry, 0);
+#else
+            madvise(const_cast<uint8*>(this->mappedData + start), size, MADV_WILLNEED);
+#endif
+        }
+        return true;
+    }
+
+    // page aligned runs, sorted and merged
+    std::vector<std::pair<uint64, uint64>> requested;
+    for (const auto& r : ranges)
+    {
+        if ((r.size == 0) || (r.offset >= this->fileSize))
+            continue;
+        const auto end = std::min<uint64>(r.offset + std::min<uint64>(r.size, this->fileSize - r.offset) + CACHE_PAGE_SIZE - 1, this->fileSize);
+        requested.emplace_back(r.offset / CACHE_PAGE_SIZE, (end - 1) / CACHE_PAGE_SIZE + 1);
+    }
+    if (requested.empty())
+        return true;
+    std::sort(requested.begin(), requested.end());
+
+    // the pages that are already cached are not read again
+    auto pages = reinterpret_cast<CachedPages*>(this->pages);
+    std::vector<std::pair<uint64, uint64>> runs;
+    uint64 next = 0;
+    for (const auto& [first, last] : requested)
     {
-        this->currentPos = this->fileSize;
-        return BufferView(&this->cache[offset - this->start], (uint32) (this->end - offset));
+        for (auto page = std::max<>(first, next); page < last; page++)
+        {
+            if (pages->Find(page) != INVALID_PAGE_SLOT)
+                continue;
+            const auto start = page * CACHE_PAGE_SIZE;
+            if ((!runs.empty()) && (runs.back().second == start))
+                runs.back().second = std::min<uint64>(start + CACHE_PAGE_SIZE, this->fileSize);
+            else
+                runs.emplace_back(start, std::min<uint64>(start + CACHE_PAGE_SIZE, this->fileSize));
+        }
+        next = std::max<>(next, last);
     }
-    this->currentPos = this->end;
-    return BufferView(&this->cache[offset - this->start], (uint32) (this->end - offset));
+    if (runs.empty())
+        return true;
+    pages->GetReader()->Prefetch(runs);
+    return true;
+}
+uint8 DataCache::GetFromCache(uint64 offset, uint8 defaultValue) const
+{
+    if (this->mappedData)
+        return offset < this->fileSize ? this->mappedData[offset] : defaultValue;
+    auto pages = reinterpret_cast<const CachedPages*>(this->pages);
+    if (pages == nullptr)
+        return defaultValue;
+    const auto slot = pages->Find(offset / CACHE_PAGE_SIZE);
+    if ((slot == INVALID_PAGE_SLOT) || ((offset % CACHE_PAGE_SIZE) >= pages->slots[slot].size))
+        return defaultValue;
+    return this->cache[(uint64) slot * CACHE_PAGE_SIZE + (offset % CACHE_PAGE_SIZE)];
+}
+bool DataCache::ReadAt(uint64 offset, std::span<uint8> output)
+{
+    CHECK(this->fileObj, false, "File was not properly initialized !");
+    CHECK((offset <= this->fileSize) && (output.size() <= this->fileSize - offset),
+          false,
+          "Unable to read %llu bytes from %llu offset",
+          (uint64) output.size(),
+          offset);
+    if (output.empty())
+        return true;
+
+    if (this->mappedData)
+    {
+        // the mapping is never changed after it is created
+        memcpy(output.data(), this->mappedData + offset, output.size());
+        return true;
+    }
+
+    auto pages = reinterpret_cast<CachedPages*>(this->pages);
+    auto p     = output.data();
+    auto size  = (uint64) output.size();
+    while (size)
+    {
+        // DataObject::Read takes a 32 bits size
+        const auto toRead = (uint32) std::min<uint64>(size, MAX_TRANSFER_SIZE);
+        CHECK(pages->file.Read(offset, p, toRead), false, "Unable to read %u bytes from %llu offset", toRead, offset);
+        p += toRead;
+        offset += toRead;
+        size -= toRead;
+    }
+    return true;
+}
+bool DataCache::ReadChunk(uint64 offset, uint8* buffer, uint32 size)
+{
+    // read straight in the buffer of the chunk (the cached pages are not used)
+    auto pages           = reinterpret_cast<CachedPages*>(this->pages);
+    const bool readAhead = pages->IsSequential(offset, offset + size);
+    CHECK(pages->Read(offset, buffer, size), false, "Unable to read %u bytes from %llu offset", size, offset);
+    this->currentPos = offset + size;
+    if (readAhead)
+        pages->GetReader()->Advance(this->currentPos, this->fileSize);
+    return true;
 }
 bool DataCache::CopyObject(void* buffer, uint64 offset, uint32 requestedSize)
 {
@@ -149,72 +1265,233 @@ bool DataCache::CopyObject(void* buffer, uint64 offset, uint32 requestedSize)
     memcpy(buffer, b.GetData(), b.GetLength());
     return true;
 }
-Buffer DataCache::CopyToBuffer(uint64 offset, uint32 requestedSize, bool failIfRequestedSizeCanNotBeRead)
+Buffer DataCache::CopyToBuffer(uint64 offset, uint64 requestedSize, bool failIfRequestedSizeCanNotBeRead)
 {
     // sanity checks
     CHECK(requestedSize > 0, Buffer(), "Invalid requested size (should be bigger than 0)");
     CHECK(offset <= this->fileSize, Buffer(), "Invalid offset (%llu) , should be less than %llu ", offset, this->fileSize);
     if (failIfRequestedSizeCanNotBeRead)
     {
-        CHECK(offset + (uint64) requestedSize <= this->fileSize, Buffer(), "Unable to read %u bytes from %llu", requestedSize, offset);
+        CHECK(offset + requestedSize <= this->fileSize, Buffer(), "Unable to read %llu bytes from %llu", requestedSize, offset);
     }
+    requestedSize = std::min<uint64>(requestedSize, this->fileSize - offset);
+    if (requestedSize == 0)
+        return Buffer();
+    // on 32 bits systems the buffer has to fit in the address space
+    CHECK(requestedSize <= (uint64) SIZE_MAX, Buffer(), "Unable to allocate %llu bytes", requestedSize);
 
     Buffer b{};
-    b.Resize(requestedSize);
-    uint32 toRead = this->cacheSize >> 1;
-    auto p        = b.GetData();
-    while (requestedSize)
-    {
-        toRead  = std::min(toRead, requestedSize);
-        auto bv = this->Get(offset, toRead, false);
-        if (bv.Empty())
-        {
-            LOG_ERROR("Empty buffer received when reading %u bytes from %llu offset", toRead, offset);
-            if (failIfRequestedSizeCanNotBeRead)
-                return Buffer();
-            // trim the buffer size to the amount of data that was read
-            b.Resize(p - b.GetData());
-            return b;
-        }
-        if (toRead != bv.GetLength())
-        {
-            LOG_ERROR("Only %u bytes received when trying to read %u bytes from %llu offset", bv.GetLength(), toRead, offset);
-            if (failIfRequestedSizeCanNotBeRead)
-                return Buffer();
-            // copy the buffer that was read
-            if (bv.GetLength() > 0)
+    if (this->mappedData)
+    {
+        reinterpret_cast<CacheStatistics*>(this->statistics)->Request(requestedSize);
+        // a single copy straight from the mapping
+        b.Resize((size_t) requestedSize);
+        memcpy(b.GetData(), this->mappedData + offset, (size_t) requestedSize);
+        return b;
+    }
+
+    // large copies are read straight in the output buffer (Get would not keep their pages anyway)
+    if (requestedSize > (this->cacheSize >> 1))
+    {
+        reinterpret_cast<CacheStatistics*>(this->statistics)->Request(requestedSize);
+        b.Resize((size_t) requestedSize);
+        uint64 read = 0;
+        while (read < requestedSize)
+        {
+            const auto toRead = (uint32) std::min<uint64>(this->cacheSize >> 1, requestedSize - read);
+            if (ReadChunk(offset + read, b.GetData() + read, toRead) == false)
             {
-                memcpy(p, bv.GetData(), bv.GetLength());
+                if (failIfRequestedSizeCanNotBeRead)
+                    return Buffer();
+                // trim the buffer size to the amount of data that was read
+                b.Resize((size_t) read);
+                return b;
             }
-            p += bv.GetLength();
-            // trim the buffer size to the amount of data that was read
-            b.Resize(p - b.GetData());
-            return b;
+            read += toRead;
         }
-        memcpy(p, bv.GetData(), toRead);
-        p += toRead;
-        offset += toRead;
-        requestedSize -= toRead;
+        return b;
+    }
+
+    // small copies are served by the cached pages
+    const auto size = (uint32) requestedSize;
+    auto bv         = this->Get(offset, size, false);
+    if (bv.Empty())
+    {
+        LOG_ERROR("Empty buffer received when reading %u bytes from %llu offset", size, offset);
+        return Buffer();
     }
+    if (size != bv.GetLength())
+    {
+        LOG_ERROR("Only %u bytes received when trying to read %u bytes from %llu offset", bv.GetLength(), size, offset);
+        if (failIfRequestedSizeCanNotBeRead)
+            return Buffer();
+    }
+    b.Resize(bv.GetLength());
+    memcpy(b.GetData(), bv.GetData(), bv.GetLength());
     return b;
 }
-bool DataCache::WriteTo(Reference<AppCUI::OS::DataObject> output, uint64 offset, uint32 size)
+bool DataCache::WriteTo(Reference<AppCUI::OS::DataObject> output, uint64 offset, uint64 size)
 {
+    CHECK(offset + size <= this->fileSize, false, "Unable to read %llu bytes from %llu", size, offset);
     CHECK(output->SetSize(size), false, "");
     CHECK(output->SetCurrentPos(0), false, "");
 
     if (size == 0)
         return true; // nothing to write
 
-    uint32 toRead = this->cacheSize >> 1;
-    while (size)
+    // mapped data is written straight from the mapping (DataObject::Write takes a 32 bits size)
+    const auto chunkSize = this->mappedData ? MAX_TRANSFER_SIZE : (this->cacheSize >> 1);
+    auto chunks          = Chunks(offset, size, chunkSize);
+    for (const auto& chunk : chunks)
     {
-        toRead  = std::min(toRead, size);
-        auto bv = this->Get(offset, toRead, true);
-        CHECK(bv.IsValid(), false, "");
-        CHECK(output->Write(bv.begin(), toRead), false, "");
-        offset += toRead;
-        size -= toRead;
+        CHECK(output->Write(chunk.data.GetData(), (uint32) chunk.data.GetLength()), false, "");
+    }
+    CHECK(chunks.HasFailed() == false, false, "Unable to read %llu bytes from %llu", size, offset);
+    return true;
+}
+
+DataCache::Tag::Tag(DataCache& _cache, std::string_view subsystem) : cache(_cache), previous(0)
+{
+    auto stats = reinterpret_cast<CacheStatistics*>(cache.statistics);
+    if (stats)
+    {
+        previous       = stats->current;
+        stats->current = stats->Find(subsystem);
+    }
+}
+DataCache::Tag::~Tag()
+{
+    auto stats = reinterpret_cast<CacheStatistics*>(cache.statistics);
+    if (stats)
+        stats->current = previous;
+}
+DataCache::Statistics DataCache::GetStatistics() const
+{
+    Statistics result{};
+    result.hits   = this->hits;
+    result.misses = this->misses;
+    auto stats    = reinterpret_cast<const CacheStatistics*>(this->statistics);
+    if (stats == nullptr)
+        return result;
+    result.reads       = stats->io.reads.load(std::memory_order_relaxed);
+    result.failedReads = stats->io.failedReads.load(std::memory_order_relaxed);
+    result.bytesRead   = stats->io.bytesRead.load(std::memory_order_relaxed);
+    for (uint32 index = 0; index < LATENCY_BUCKETS; index++)
+        result.latency[index] = stats->io.latency[index].load(std::memory_order_relaxed);
+    result.largestRequest = stats->largestRequest;
+    for (const auto& subsystem : stats->subsystems)
+        if (subsystem.requests > 0)
+            result.subsystems.push_back(subsystem);
+    return result;
+}
+void DataCache::ResetStatistics()
+{
+    this->hits   = 0;
+    this->misses = 0;
+    auto stats   = reinterpret_cast<CacheStatistics*>(this->statistics);
+    if (stats)
+        stats->Reset();
+}
+bool DataCache::WriteStatistics(const std::filesystem::path& path) const
+{
+    CHECK(this->fileObj, false, "File was not properly initialized !");
+    const auto stats = GetStatistics();
+    const auto pages = stats.hits + stats.misses;
+
+    String text;
+    text.AddFormat("File size       : %llu bytes\n", this->fileSize);
+    text.AddFormat("Cache size      : %u bytes%s\n", this->cacheSize, this->mappedData ? " (memory mapped)" : "");
+    text.AddFormat("Page hits       : %llu\n", stats.hits);
+    text.AddFormat("Page misses     : %llu\n", stats.misses);
+    if (pages > 0)
+        text.AddFormat("Hit rate        : %.2f%%\n", (double) stats.hits * 100.0 / (double) pages);
+    text.AddFormat("File reads      : %llu (%llu failed)\n", stats.reads, stats.failedReads);
+    text.AddFormat("Bytes read      : %llu\n", stats.bytesRead);
+    text.AddFormat("Largest request : %llu bytes\n", stats.largestRequest);
+
+    text.AddFormat("\nRead latency\n");
+    for (uint32 index = 0; index < LATENCY_BUCKETS; index++)
+    {
+        if (stats.latency[index] == 0)
+            continue;
+        if (index + 1 == LATENCY_BUCKETS)
+            text.AddFormat("  >= %8llu us : %llu\n", 1ULL << (index - 1), stats.latency[index]);
+        else
+            text.AddFormat("  <  %8llu us : %llu\n", 1ULL << index, stats.latency[index]);
+    }
+
+    text.AddFormat("\n%-24s %12s %16s %12s %12s\n", "Subsystem", "Requests", "Bytes", "Hits", "Misses");
+    for (const auto& subsystem : stats.subsystems)
+        text.AddFormat("%-24s %12llu %16llu %12llu %12llu\n",
+                       subsystem.name.empty() ? "(not tagged)" : subsystem.name.c_str(),
+                       subsystem.requests,
+                       subsystem.requestedBytes,
+                       subsystem.hits,
+                       subsystem.misses);
+
+    CHECK(AppCUI::OS::File::WriteContent(path, BufferView(text.GetText(), text.Len())), false, "Fail to write the cache statistics");
+    return true;
+}
+
+ChunkRange DataCache::Chunks(uint64 offset, uint64 size, uint32 chunkSize, uint32 overlap)
+{
+    return ChunkRange(this, offset, size, chunkSize, overlap);
+}
+
+ChunkRange::ChunkRange(DataCache* _cache, uint64 offset, uint64 size, uint32 _chunkSize, uint32 _overlap)
+{
+    this->cache     = _cache;
+    this->position  = std::min<uint64>(offset, _cache->GetSize());
+    this->rangeEnd       = this->position + std::min<uint64>(size, _cache->GetSize() - this->position);
+    this->chunkSize = std::max<uint32>(_chunkSize, 1);
+    this->overlap   = std::min<uint32>(_overlap, this->chunkSize - 1);
+    this->current   = { this->position, BufferView() };
+    this->started   = false;
+    this->failed    = false;
+}
+ChunkRange::Iterator ChunkRange::begin()
+{
+    if ((this->started == false) && Next())
+        return Iterator(this);
+    return Iterator(nullptr);
+}
+bool ChunkRange::Next()
+{
+    this->started = true;
+    if (this->position >= this->rangeEnd)
+        return false;
+
+    const auto size = (uint32) std::min<uint64>(this->chunkSize, this->rangeEnd - this->position);
+    if (this->cache->IsMapped())
+    {
+        // zero copy
+        this->current = { this->position, this->cache->Get(this->position, size, true) };
+    }
+    else
+    {
+        // the first chunk is the largest one
+        if (this->buffer.GetLength() == 0)
+            this->buffer.Resize(size);
+        // the bytes shared with the previous chunk are not read again
+        uint32 reused          = 0;
+        const auto previousEnd = this->current.offset + this->current.data.GetLength();
+        if (this->current.data.IsValid() && (previousEnd > this->position))
+        {
+            reused = (uint32) (previousEnd - this->position);
+            memmove(this->buffer.GetData(), this->buffer.GetData() + (this->position - this->current.offset), reused);
+        }
+        reinterpret_cast<CacheStatistics*>(this->cache->statistics)->Request(size - reused);
+        if (this->cache->ReadChunk(this->position + reused, this->buffer.GetData() + reused, size - reused))
+            this->current = { this->position, BufferView(this->buffer.GetData(), size) };
+        else
+            this->current = { this->position, BufferView() };
+    }
+    if (this->current.data.IsValid() == false)
+    {
+        this->failed   = true;
+        this->position = this->rangeEnd;
+        return false;
     }
+    this->position = (this->position + size >= this->rangeEnd) ? this->rangeEnd : this->position + size - this->overlap;
     return true;
 }
@@ -0,0 +1,210 @@
+#include "GView.hpp"
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace GView::Utils::DecodedObjects
+{
+constexpr uint64 DEFAULT_MEMORY_BUDGET = 0x10000000; // 256 MB
+
+constexpr uint64 PRIME_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64 PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64 PRIME_3 = 0x165667B19E3779F9ULL;
+constexpr uint64 PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64 PRIME_5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64 RotateLeft(uint64 value, uint32 count)
+{
+    return (value << count) | (value >> (64 - count));
+}
+static inline uint64 Read64(const uint8* p)
+{
+    uint64 value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+static inline uint64 Round(uint64 lane, uint64 value)
+{
+    return RotateLeft(lane + value * PRIME_2, 31) * PRIME_1;
+}
+static inline uint64 Mix(uint64 value)
+{
+    value ^= value >> 33;
+    value *= PRIME_2;
+    value ^= value >> 29;
+    value *= PRIME_3;
+    value ^= value >> 32;
+    return value;
+}
+
+KeyBuilder::KeyBuilder()
+{
+    lanes[0]    = PRIME_1 + PRIME_2;
+    lanes[1]    = PRIME_2;
+    lanes[2]    = 0;
+    lanes[3]    = 0 - PRIME_1;
+    pendingSize = 0;
+    size        = 0;
+}
+void KeyBuilder::Update(BufferView data)
+{
+    auto p         = data.GetData();
+    auto remaining = (uint64) data.GetLength();
+    size += remaining;
+
+    // 32 bytes stripes (4 independent lanes), the bytes that do not fill a stripe wait for the next call
+    if (pendingSize > 0)
+    {
+        const auto count = (uint32) std::min<uint64>(remaining, sizeof(pending) - pendingSize);
+        memcpy(pending + pendingSize, p, count);
+        pendingSize += count;
+        p += count;
+        remaining -= count;
+        if (pendingSize < sizeof(pending))
+            return;
+        for (uint32 i = 0; i < 4; i++)
+            lanes[i] = Round(lanes[i], Read64(pending + i * 8));
+        pendingSize = 0;
+    }
+    for (; remaining >= sizeof(pending); p += sizeof(pending), remaining -= sizeof(pending))
+    {
+        lanes[0] = Round(lanes[0], Read64(p));
+        lanes[1] = Round(lanes[1], Read64(p + 8));
+        lanes[2] = Round(lanes[2], Read64(p + 16));
+        lanes[3] = Round(lanes[3], Read64(p + 24));
+    }
+    memcpy(pending, p, (size_t) remaining);
+    pendingSize = (uint32) remaining;
+}
+Key KeyBuilder::GetKey(Transform transform, uint64 parameter) const
+{
+    uint64 first  = RotateLeft(lanes[0], 1) + RotateLeft(lanes[1], 7) + RotateLeft(lanes[2], 12) + RotateLeft(lanes[3], 18);
+    uint64 second = RotateLeft(lanes[0], 29) ^ RotateLeft(lanes[1], 41) ^ RotateLeft(lanes[2], 53) ^ lanes[3];
+    for (uint32 i = 0; i < 4; i++)
+    {
+        first  = (first ^ Round(0, lanes[i])) * PRIME_1 + PRIME_4;
+        second = (second ^ Round(PRIME_5, lanes[i])) * PRIME_2 + PRIME_3;
+    }
+    first += size;
+    second ^= size * PRIME_5;
+
+    uint32 i = 0;
+    for (; i + 8 <= pendingSize; i += 8)
+    {
+        const auto value = Read64(pending + i);
+        first            = RotateLeft(first ^ Round(0, value), 27) * PRIME_1 + PRIME_4;
+        second           = RotateLeft(second ^ (value * PRIME_3), 31) * PRIME_2 + PRIME_5;
+    }
+    for (; i < pendingSize; i++)
+    {
+        first  = RotateLeft(first ^ (pending[i] * PRIME_5), 11) * PRIME_1;
+        second = RotateLeft(second ^ (pending[i] * PRIME_1), 13) * PRIME_3;
+    }
+
+    Key key;
+    key.hash[0]    = Mix(first);
+    key.hash[1]    = Mix(second ^ first);
+    key.sourceSize = size;
+    key.parameter  = parameter;
+    key.transform  = transform;
+    return key;
+}
+Key ComputeKey(BufferView source, Transform transform, uint64 parameter)
+{
+    KeyBuilder builder;
+    builder.Update(source);
+    return builder.GetKey(transform, parameter);
+}
+
+struct KeyHasher
+{
+    size_t operator()(const Key& key) const
+    {
+        return (size_t) (key.hash[0] ^ (key.parameter * PRIME_1) ^ (uint64) key.transform);
+    }
+};
+struct CachedObject
+{
+    Key key;
+    std::vector<uint8> data;
+    uint64 consumed;
+};
+// the windows (and the plugins) can decode objects from different threads
+struct Cache
+{
+    std::mutex lock;
+    std::list<CachedObject> objects; // most recently used first
+    std::unordered_map<Key, std::list<CachedObject>::iterator, KeyHasher> index;
+    uint64 budget, used;
+
+    Cache() : budget(DEFAULT_MEMORY_BUDGET), used(0)
+    {
+    }
+    void Remove(std::list<CachedObject>::iterator it)
+    {
+        used -= it->data.size();
+        index.erase(it->key);
+        objects.erase(it);
+    }
+    void Shrink()
+    {
+        while (used > budget)
+            Remove(std::prev(objects.end()));
+    }
+};
+static Cache& GetCache()
+{
+    static Cache cache;
+    return cache;
+}
+
+bool Find(const Key& key, Buffer& output, uint64* consumed)
+{
+    auto& cache = GetCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+    auto it = cache.index.find(key);
+    if (it == cache.index.end())
+        return false;
+    auto obj = it->second;
+    cache.objects.splice(cache.objects.begin(), cache.objects, obj);
+    output.Resize(obj->data.size());
+    memcpy(output.GetData(), obj->data.data(), obj->data.size());
+    if (consumed)
+        *consumed = obj->consumed;
+    return true;
+}
+void Add(const Key& key, BufferView object, uint64 consumed)
+{
+    auto& cache = GetCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+    auto it = cache.index.find(key);
+    if (it != cache.index.end())
+        cache.Remove(it->second);
+    if (object.GetLength() > cache.budget)
+        return;
+    cache.objects.push_front({ key, std::vector<uint8>(object.GetData(), object.GetData() + object.GetLength()), consumed });
+    cache.index[key] = cache.objects.begin();
+    cache.used += object.GetLength();
+    cache.Shrink();
+}
+void SetMemoryBudget(uint64 size)
+{
+    auto& cache = GetCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+    cache.budget = size;
+    cache.Shrink();
+}
+uint64 GetMemoryBudget()
+{
+    auto& cache = GetCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+    return cache.budget;
+}
+uint64 GetMemoryUsage()
+{
+    auto& cache = GetCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+    return cache.used;
+}
+} // namespace GView::Utils::DecodedObjects
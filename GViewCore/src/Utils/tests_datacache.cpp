@@ -0,0 +1,401 @@
+#include <catch.hpp>
+#include "GView.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <set>
+#include <thread>
+
+using namespace GView::Utils;
+
+enum class ReadMode {
+    DataObject,
+    PositionalReader, // batched reads (io_uring) where they are supported
+    PlainPositionalReader,
+    Mapped
+};
+constexpr ReadMode ALL_READ_MODES[] = { ReadMode::DataObject, ReadMode::PositionalReader, ReadMode::PlainPositionalReader, ReadMode::Mapped };
+constexpr const char* READ_MODE_NAMES[] = { "data object", "positional reader", "plain positional", "mapped" };
+
+static bool OpenCache(DataCache& cache, const std::filesystem::path& path, ReadMode mode, uint32 cacheSize)
+{
+    auto file = std::make_unique<AppCUI::OS::File>();
+    if (!file->OpenRead(path) || !cache.Init(std::move(file), cacheSize)) {
+        return false;
+    }
+    switch (mode) {
+    case ReadMode::PositionalReader:
+        return cache.OpenReader(path, true);
+    case ReadMode::PlainPositionalReader:
+        return cache.OpenReader(path, false);
+    case ReadMode::Mapped:
+        return cache.MapFile(path);
+    default:
+        return true;
+    }
+}
+
+// small files and caches: the cache of 64 K serves requests of up to 64 K and holds 2 pages of 16 K
+constexpr uint32 TEST_CACHE_SIZE = 0x10000;
+constexpr uint32 TEST_PAGE_SIZE  = 0x4000;
+constexpr uint64 TEST_FILE_SIZE  = 0x4A123;
+
+struct TestFile {
+    std::filesystem::path path;
+    std::vector<uint8> content;
+
+    TestFile(std::string_view name, uint64 size) : path(std::filesystem::temp_directory_path() / name), content(size)
+    {
+        std::mt19937_64 generator(size);
+        for (auto& b : content) {
+            b = (uint8) generator();
+        }
+    }
+    ~TestFile()
+    {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+    bool Write() const
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(content.data()), content.size());
+        return (bool) out;
+    }
+    bool Matches(uint64 offset, BufferView data) const
+    {
+        return data.IsValid() && (offset + data.GetLength() <= content.size()) && (memcmp(data.GetData(), content.data() + offset, data.GetLength()) == 0);
+    }
+};
+
+TEST_CASE("DataCacheChunks", "[DataCache]")
+{
+    constexpr std::string_view MARKER = "GVIEW-CHUNK-MARKER";
+    constexpr uint64 START            = 10;
+    constexpr uint32 CHUNK_SIZE       = 0x3000;
+    constexpr uint32 OVERLAP          = (uint32) MARKER.size() - 1;
+
+    TestFile file("gview_datacache_chunks.bin", TEST_FILE_SIZE);
+    // markers that straddle the chunk boundaries (and one at the very end of the file)
+    std::set<uint64> markers;
+    for (uint64 boundary = START + CHUNK_SIZE; boundary < TEST_FILE_SIZE; boundary += 7 * (CHUNK_SIZE - OVERLAP)) {
+        markers.insert(boundary - 5);
+    }
+    markers.insert(TEST_FILE_SIZE - MARKER.size());
+    for (auto offset : markers) {
+        memcpy(file.content.data() + offset, MARKER.data(), MARKER.size());
+    }
+    REQUIRE(file.Write());
+
+    for (auto mode : ALL_READ_MODES) {
+        INFO(READ_MODE_NAMES[(uint32) mode]);
+        DataCache cache;
+        REQUIRE(OpenCache(cache, file.path, mode, TEST_CACHE_SIZE));
+
+        // every chunk starts where the previous one ends minus the overlap and the last one ends with the range
+        std::set<uint64> found;
+        uint64 expectedOffset = START, count = 0;
+        BufferView previous;
+        std::vector<uint8> previousTail;
+        auto chunks = cache.Chunks(START, TEST_FILE_SIZE, CHUNK_SIZE, OVERLAP);
+        for (const auto& chunk : chunks) {
+            REQUIRE(chunk.offset == expectedOffset);
+            REQUIRE(chunk.data.GetLength() == std::min<uint64>(CHUNK_SIZE, TEST_FILE_SIZE - chunk.offset));
+            REQUIRE(file.Matches(chunk.offset, chunk.data));
+            // the overlap holds the last bytes of the previous chunk
+            if (count > 0) {
+                REQUIRE(memcmp(chunk.data.GetData(), previousTail.data(), OVERLAP) == 0);
+            }
+            previousTail.assign(chunk.data.GetData() + chunk.data.GetLength() - OVERLAP, chunk.data.GetData() + chunk.data.GetLength());
+            const std::string_view text(reinterpret_cast<const char*>(chunk.data.GetData()), chunk.data.GetLength());
+            for (auto pos = text.find(MARKER); pos != std::string_view::npos; pos = text.find(MARKER, pos + 1)) {
+                found.insert(chunk.offset + pos);
+            }
+            expectedOffset = chunk.offset + chunk.data.GetLength() - OVERLAP;
+            count++;
+        }
+        REQUIRE(expectedOffset + OVERLAP == TEST_FILE_SIZE);
+        REQUIRE(chunks.HasFailed() == false);
+        REQUIRE(found == markers);
+
+        // ranges are clipped to the end of the file and a range that starts after it has no chunks
+        uint64 size = 0;
+        for (const auto& chunk : cache.Chunks(TEST_FILE_SIZE - 100, 1000, 64)) {
+            REQUIRE(file.Matches(chunk.offset, chunk.data));
+            size += chunk.data.GetLength();
+        }
+        REQUIRE(size == 100);
+        auto empty = cache.Chunks(TEST_FILE_SIZE + 1, 100, 64);
+        for (const auto& chunk : empty) {
+            FAIL("unexpected chunk at " << chunk.offset);
+        }
+        REQUIRE(empty.HasFailed() == false);
+    }
+}
+
+TEST_CASE("DataCacheChunksFailure", "[DataCache]")
+{
+    TestFile file("gview_datacache_truncated.bin", TEST_FILE_SIZE);
+    REQUIRE(file.Write());
+
+    // the data object is a copy of the file, the positional reader reads the file itself (that is truncated after it was opened)
+    for (auto mode : { ReadMode::PositionalReader, ReadMode::PlainPositionalReader }) {
+        INFO(READ_MODE_NAMES[(uint32) mode]);
+        REQUIRE(file.Write());
+        auto memory = std::make_unique<AppCUI::OS::MemoryFile>();
+        REQUIRE(memory->Create(file.content.data(), file.content.size()));
+        DataCache cache;
+        REQUIRE(cache.Init(std::move(memory), TEST_CACHE_SIZE));
+        REQUIRE(cache.OpenReader(file.path, mode == ReadMode::PositionalReader));
+        std::filesystem::resize_file(file.path, TEST_FILE_SIZE / 2);
+
+        uint64 end  = 0;
+        auto chunks = cache.Chunks(0, TEST_FILE_SIZE, 0x1000);
+        for (const auto& chunk : chunks) {
+            REQUIRE(file.Matches(chunk.offset, chunk.data));
+            end = chunk.offset + chunk.data.GetLength();
+        }
+        REQUIRE(chunks.HasFailed());
+        REQUIRE(end <= TEST_FILE_SIZE / 2);
+    }
+}
+
+TEST_CASE("DataCacheStitching", "[DataCache]")
+{
+    TestFile file("gview_datacache_stitching.bin", TEST_FILE_SIZE);
+    REQUIRE(file.Write());
+
+    for (auto mode : ALL_READ_MODES) {
+        INFO(READ_MODE_NAMES[(uint32) mode]);
+        DataCache cache;
+        REQUIRE(OpenCache(cache, file.path, mode, TEST_CACHE_SIZE));
+        const auto largest = cache.GetCacheSize();
+        REQUIRE(largest == TEST_CACHE_SIZE);
+
+        // requests that span over several pages, including the largest one at an offset that is not page aligned
+        for (uint64 offset : { TEST_PAGE_SIZE - 1ULL, 3ULL * TEST_PAGE_SIZE + 100, 0x20001ULL }) {
+            for (uint32 size : { 2u, (uint32) TEST_PAGE_SIZE + 1, 3u * TEST_PAGE_SIZE, largest }) {
+                REQUIRE(file.Matches(offset, cache.Get(offset, size, true)));
+                REQUIRE(cache.Get(offset, size, true).GetLength() == size);
+            }
+        }
+
+        // several requests inside one window stay valid together
+        const uint64 base = 5 * TEST_PAGE_SIZE;
+        auto first        = cache.Get(base + 10, TEST_PAGE_SIZE, true);
+        auto second       = cache.Get(base + TEST_PAGE_SIZE / 2, 2 * TEST_PAGE_SIZE, true);
+        auto third        = cache.Get(base + 2 * TEST_PAGE_SIZE + 7, TEST_PAGE_SIZE, true);
+        REQUIRE(file.Matches(base + 10, first));
+        REQUIRE(file.Matches(base + TEST_PAGE_SIZE / 2, second));
+        REQUIRE(file.Matches(base + 2 * TEST_PAGE_SIZE + 7, third));
+
+        // larger requests fail or are truncated to the largest size and requests past the end of the file are truncated to it
+        if (!cache.IsMapped()) {
+            REQUIRE(cache.Get(0, largest + 1, true).IsValid() == false);
+            REQUIRE(cache.Get(0, largest + 1, false).GetLength() == largest);
+        }
+        REQUIRE(cache.Get(TEST_FILE_SIZE - 10, 2 * TEST_PAGE_SIZE, true).IsValid() == false);
+        auto tail = cache.Get(TEST_FILE_SIZE - TEST_PAGE_SIZE - 10, 2 * TEST_PAGE_SIZE, false);
+        REQUIRE(tail.GetLength() == TEST_PAGE_SIZE + 10);
+        REQUIRE(file.Matches(TEST_FILE_SIZE - TEST_PAGE_SIZE - 10, tail));
+        REQUIRE(cache.Get(TEST_FILE_SIZE, 1, false).IsValid() == false);
+    }
+}
+
+TEST_CASE("DataCacheEntireFile", "[DataCache]")
+{
+    // files of up to the cache size are viewed at once (the pages are allocated on top of the stitch window)
+    TestFile file("gview_datacache_entire.bin", 0xC123);
+    REQUIRE(file.Write());
+
+    for (auto mode : ALL_READ_MODES) {
+        INFO(READ_MODE_NAMES[(uint32) mode]);
+        DataCache cache;
+        REQUIRE(OpenCache(cache, file.path, mode, TEST_CACHE_SIZE));
+        auto entire = cache.GetEntireFile();
+        REQUIRE(entire.GetLength() == file.content.size());
+        REQUIRE(file.Matches(0, entire));
+
+        // a cache initialized with the size of another one has the same size (the searches on several threads rely on it)
+        DataCache other;
+        REQUIRE(OpenCache(other, file.path, mode, cache.GetCacheSize()));
+        REQUIRE(other.GetCacheSize() == cache.GetCacheSize());
+    }
+}
+
+TEST_CASE("DataCacheEviction", "[DataCache]")
+{
+    TestFile file("gview_datacache_eviction.bin", TEST_FILE_SIZE);
+    REQUIRE(file.Write());
+
+    for (auto mode : { ReadMode::DataObject, ReadMode::PositionalReader }) {
+        INFO(READ_MODE_NAMES[(uint32) mode]);
+        DataCache cache;
+        REQUIRE(OpenCache(cache, file.path, mode, TEST_CACHE_SIZE));
+        cache.Hint(DataCache::AccessPattern::Random);
+
+        // reads a few bytes of a page and returns true if it was already cached
+        auto read = [&](uint64 page) {
+            const auto misses = cache.GetMissesCount();
+            REQUIRE(file.Matches(page * TEST_PAGE_SIZE + 1, cache.Get(page * TEST_PAGE_SIZE + 1, 16, true)));
+            return cache.GetMissesCount() == misses;
+        };
+        auto isCached = [&](uint64 page) {
+            const auto offset = page * TEST_PAGE_SIZE + 1;
+            return cache.GetFromCache(offset, file.content[offset] ^ 0xFF) == file.content[offset];
+        };
+
+        // the cache holds two pages: the least recently used one is evicted
+        REQUIRE(read(0) == false);
+        REQUIRE(read(1) == false);
+        REQUIRE(read(0));
+        REQUIRE(read(2) == false);
+        REQUIRE(isCached(0));
+        REQUIRE(isCached(1) == false);
+        REQUIRE(isCached(2));
+        REQUIRE(read(0));
+        REQUIRE(read(1) == false);
+        REQUIRE(isCached(2) == false);
+        REQUIRE(cache.GetHitsCount() == 2);
+        REQUIRE(cache.GetMissesCount() == 4);
+    }
+}
+
+TEST_CASE("DataCacheReadAt", "[DataCache]")
+{
+    TestFile file("gview_datacache_readat.bin", TEST_FILE_SIZE);
+    REQUIRE(file.Write());
+
+    for (auto mode : ALL_READ_MODES) {
+        INFO(READ_MODE_NAMES[(uint32) mode]);
+        DataCache cache;
+        REQUIRE(OpenCache(cache, file.path, mode, TEST_CACHE_SIZE));
+
+        std::vector<uint8> buffer(10);
+        REQUIRE(cache.ReadAt(TEST_FILE_SIZE - 10, buffer));
+        REQUIRE(file.Matches(TEST_FILE_SIZE - 10, BufferView(buffer.data(), buffer.size())));
+        REQUIRE(cache.ReadAt(TEST_FILE_SIZE - 9, buffer) == false);
+        REQUIRE(cache.ReadAt(TEST_FILE_SIZE, std::span<uint8>()));
+
+        // workers read with ReadAt while the thread that owns the cache uses Get (REQUIRE is not thread safe, so the workers
+        // only count the errors)
+        std::atomic<uint32> errors = 0;
+        std::vector<std::thread> workers;
+        for (uint32 index = 0; index < 3; index++) {
+            workers.emplace_back([&, index]() {
+                std::mt19937_64 generator(index);
+                std::vector<uint8> data;
+                for (uint32 i = 0; i < 200; i++) {
+                    data.resize(1 + generator() % (2 * TEST_CACHE_SIZE));
+                    const auto offset = generator() % (TEST_FILE_SIZE - data.size());
+                    if (!cache.ReadAt(offset, data) || !file.Matches(offset, BufferView(data.data(), data.size()))) {
+                        errors++;
+                    }
+                }
+            });
+        }
+        std::mt19937_64 generator(0x5EED);
+        for (uint32 i = 0; i < 500; i++) {
+            const auto offset = generator() % TEST_FILE_SIZE;
+            if (!file.Matches(offset, cache.Get(offset, 1 + (uint32) (generator() % TEST_PAGE_SIZE), false))) {
+                errors++;
+            }
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        REQUIRE(errors == 0);
+    }
+}
+
+// compares the ways a DataCache can read a regular file: through the data object (SetCurrentPos + Read), through a
+// separate handle (pread / io_uring) and memory mapped
+// hidden test, run it with: GViewCore "[benchmark]"
+
+constexpr uint64 BENCHMARK_FILE_SIZE     = 0x10000000; // 256 MB
+constexpr uint32 BENCHMARK_CACHE_SIZE    = 0x100000;
+constexpr uint32 BENCHMARK_RANDOM_READS  = 50000;
+constexpr uint32 BENCHMARK_PREFETCH_RUNS = 200;
+
+static bool CreateBenchmarkFile(const std::filesystem::path& path)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    std::vector<uint8> block(0x100000);
+    std::mt19937_64 generator(0x5EED);
+    for (uint64 written = 0; written < BENCHMARK_FILE_SIZE && out; written += block.size()) {
+        for (auto& b : block) {
+            b = (uint8) generator();
+        }
+        out.write(reinterpret_cast<const char*>(block.data()), block.size());
+    }
+    return (bool) out;
+}
+
+template <typename F>
+static double Measure(F&& f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+TEST_CASE("DataCacheReadModes", "[.benchmark][DataCache]")
+{
+    const auto path = std::filesystem::temp_directory_path() / "gview_datacache_benchmark.bin";
+    REQUIRE(CreateBenchmarkFile(path));
+
+    for (auto mode : ALL_READ_MODES) {
+        DataCache cache;
+        REQUIRE(OpenCache(cache, path, mode, BENCHMARK_CACHE_SIZE));
+
+        std::mt19937_64 generator(0x5EED);
+        uint64 checksum = 0;
+
+        // random 4 KB reads (almost every one of them is a miss)
+        const auto random = Measure([&]() {
+            for (uint32 i = 0; i < BENCHMARK_RANDOM_READS; i++) {
+                const auto offset = (generator() % (BENCHMARK_FILE_SIZE / 0x1000)) * 0x1000;
+                auto view         = cache.Get(offset, 0x1000, true);
+                REQUIRE(view.IsValid());
+                checksum += view[0];
+            }
+        });
+
+        // sequential scan of the entire file
+        const auto sequential = Measure([&]() {
+            uint64 size = 0;
+            for (const auto& chunk : cache.Chunks(0, BENCHMARK_FILE_SIZE, 0x10000)) {
+                size += chunk.data.GetLength();
+                checksum += chunk.data[0];
+            }
+            REQUIRE(size == BENCHMARK_FILE_SIZE);
+        });
+
+        // batches of scattered ranges announced with Prefetch and then read
+        const auto prefetch = Measure([&]() {
+            DataCache::Range ranges[16];
+            for (uint32 run = 0; run < BENCHMARK_PREFETCH_RUNS; run++) {
+                for (auto& r : ranges) {
+                    r = { generator() % (BENCHMARK_FILE_SIZE - 0x8000), 0x8000 };
+                }
+                cache.Prefetch(ranges);
+                for (const auto& r : ranges) {
+                    auto view = cache.Get(r.offset, (uint32) r.size, true);
+                    REQUIRE(view.IsValid());
+                    checksum += view[0];
+                }
+            }
+        });
+
+        std::printf("%-18s random 4 KB: %8.1f ms  sequential: %8.1f ms  prefetch: %8.1f ms  (checksum %llu)\n",
+                    READ_MODE_NAMES[(uint32) mode],
+                    random,
+                    sequential,
+                    prefetch,
+                    (unsigned long long) checksum);
+    }
+
+    std::error_code error;
+    std::filesystem::remove(path, error);
+}
@@ -6,6 +6,9 @@
 
 namespace GView::View::BufferViewer
 {
+// a match that is longer than this can be cut at the boundary between two chunks
+constexpr uint32 SEARCH_CHUNKS_OVERLAP = 0x1000;
+
 constexpr int32 BTN_ID_OK     = 1;
 constexpr int32 BTN_ID_CANCEL = 2;
 
@@ -429,6 +432,7 @@ bool FindDialog::ProcessInput(uint64 end, bool last)
         }
     }
     ProgressStatus::Init("Searching...", objectSize);
+    GView::Utils::DataCache::Tag tag(object->GetData(), "FindDialog");
 
     LocalString<512> ls;
     const char* format = "Reading [0x%.8llX/0x%.8llX] bytes...";
@@ -437,62 +441,63 @@ bool FindDialog::ProcessInput(uint64 end, bool last)
         format = "[0x%.16llX/0x%.16llX] bytes...";
     }
 
-    const auto block = (last && end != GView::Utils::INVALID_OFFSET) ? (end - currentPos) : object->GetData().GetCacheSize();
+    const auto block   = (last && end != GView::Utils::INVALID_OFFSET) ? (end - currentPos) : object->GetData().GetCacheSize();
+    const auto overlap = static_cast<uint32>(std::min<uint64>(SEARCH_CHUNKS_OVERLAP, block / 2));
 
     const auto SearchInAsciiChunk = [&](uint64 offset, uint64 left, const std::regex& pattern)
     {
-        do
+        const auto rangeEnd = offset + left;
+        auto chunks         = object->GetData().Chunks(offset, left, static_cast<uint32>(block), overlap);
+        for (const auto& chunk : chunks)
         {
-            CHECK(ProgressStatus::Update(offset, ls.Format(format, offset, objectSize)) == false, false, "");
-
-            const auto sizeToRead = (left >= block ? block : left);
-            left -= (left >= block ? block : left);
-
-            const auto buffer = object->GetData().Get(offset, static_cast<uint32>(sizeToRead), true);
-            CHECK(buffer.IsValid(), false, "");
-
-            const auto initialStart = reinterpret_cast<char const*>(buffer.GetData());
-            auto start              = reinterpret_cast<char const*>(buffer.GetData());
-            const auto end          = reinterpret_cast<char const*>(start + buffer.GetLength());
+            CHECK(ProgressStatus::Update(chunk.offset, ls.Format(format, chunk.offset, objectSize)) == false, false, "");
+
+            // matches starting in the overlap are found in the next chunk (where they are not cut)
+            const auto isLastChunk  = chunk.offset + chunk.data.GetLength() == rangeEnd;
+            const auto searchLimit  = isLastChunk ? chunk.data.GetLength() : chunk.data.GetLength() - overlap;
+            const auto initialStart = reinterpret_cast<char const*>(chunk.data.GetData());
+            auto start              = reinterpret_cast<char const*>(chunk.data.GetData());
+            const auto end          = reinterpret_cast<char const*>(start + chunk.data.GetLength());
             std::cmatch matches{};
             while (std::regex_search(start, end, matches, pattern))
             {
-                match = std::pair<uint64, uint64>{ offset + (start - initialStart) + matches.position(), matches.length() };
+                const auto position = static_cast<uint64>((start - initialStart) + matches.position());
+                CHECKBK(position < searchLimit, "");
+                match = std::pair<uint64, uint64>{ chunk.offset + position, matches.length() };
                 start += matches.position() + matches.length();
-                CHECKBK(last, "");
+                CHECK(last, true, "");
             }
-
-            offset += sizeToRead;
-        } while (left > 0);
+        }
+        CHECK(chunks.HasFailed() == false, false, "");
 
         return true;
     };
 
     const auto SearchInUnicodeChunk = [&](uint64 offset, uint64 left, const std::wregex& pattern)
     {
-        do
+        const auto rangeEnd = offset + left;
+        auto chunks         = object->GetData().Chunks(offset, left, static_cast<uint32>(block), overlap);
+        for (const auto& chunk : chunks)
         {
-            CHECK(ProgressStatus::Update(offset, ls.Format(format, offset, objectSize)) == false, false, "");
-
-            const auto sizeToRead = (left >= block ? block : left);
-            left -= (left >= block ? block : left);
-
-            const auto buffer = object->GetData().Get(offset, static_cast<uint32>(sizeToRead), true);
-            CHECK(buffer.IsValid(), false, "");
-
-            auto initialStart = reinterpret_cast<wchar_t const*>(buffer.GetData());
-            auto start        = reinterpret_cast<wchar_t const*>(buffer.GetData());
-            const auto end    = reinterpret_cast<wchar_t const*>(start + buffer.GetLength());
+            CHECK(ProgressStatus::Update(chunk.offset, ls.Format(format, chunk.offset, objectSize)) == false, false, "");
+
+            // matches starting in the overlap are found in the next chunk (where they are not cut)
+            const auto isLastChunk  = chunk.offset + chunk.data.GetLength() == rangeEnd;
+            const auto searchLimit  = isLastChunk ? chunk.data.GetLength() : chunk.data.GetLength() - overlap;
+            const auto initialStart = reinterpret_cast<wchar_t const*>(chunk.data.GetData());
+            auto start              = reinterpret_cast<wchar_t const*>(chunk.data.GetData());
+            const auto end          = reinterpret_cast<wchar_t const*>(chunk.data.GetData() + (chunk.data.GetLength() & ~(sizeof(wchar_t) - 1)));
             std::wcmatch matches{};
             while (std::regex_search(start, end, matches, pattern))
             {
-                match = std::pair<uint64, uint64>{ offset + (start - initialStart) * sizeof(wchar_t) + matches.position(), matches.length() };
+                const auto position = static_cast<uint64>((start - initialStart) + matches.position()) * sizeof(wchar_t);
+                CHECKBK(position < searchLimit, "");
+                match = std::pair<uint64, uint64>{ chunk.offset + position, matches.length() };
                 start += matches.position() + matches.length();
-                CHECKBK(last, "");
+                CHECK(last, true, "");
             }
-
-            offset += sizeToRead;
-        } while (left > 0);
+        }
+        CHECK(chunks.HasFailed() == false, false, "");
 
         return true;
     };
@@ -1038,6 +1038,7 @@ void Instance::Paint(Renderer& renderer)
         settings->zList.SetCache({ startView, ((uint64) Layout.charactersPerLine) * (Layout.visibleRows - 1ull) + startView });
     }
 
+    GView::Utils::DataCache::Tag tag(obj->GetData(), "BufferViewer");
     DrawLineInfo dli;
     for (uint32 tr = 0; tr < Layout.visibleRows; tr++) {
         dli.offset = ((uint64) Layout.charactersPerLine) * tr + startView;
@@ -0,0 +1,95 @@
+#include "ImageViewer.hpp"
+
+using namespace GView::View::ImageViewer;
+
+struct DownscalerContext
+{
+    uint32 width, height;             // full resolution image
+    uint32 outputWidth, outputHeight; // reduced image
+    uint32 divider;
+    std::vector<uint32> sums; // Blue, Green, Red, Alpha sums for every pixel of the reduced image
+};
+
+ImageDownscaler::ImageDownscaler()
+{
+    context = nullptr;
+}
+ImageDownscaler::~ImageDownscaler()
+{
+    if (context)
+        delete reinterpret_cast<DownscalerContext*>(context);
+    context = nullptr;
+}
+bool ImageDownscaler::Init(uint32 width, uint32 height, uint32 divider)
+{
+    CHECK(width > 0 && height > 0, false, "Invalid image size: %u x %u", width, height);
+    CHECK(divider > 0 && divider <= 256, false, "Invalid divider: %u", divider); // 256 * 256 * 255 still fits in 32 bits
+
+    if (!context)
+        context = new DownscalerContext();
+    auto ctx          = reinterpret_cast<DownscalerContext*>(context);
+    ctx->width        = width;
+    ctx->height       = height;
+    ctx->divider      = divider;
+    ctx->outputWidth  = (width + divider - 1) / divider;
+    ctx->outputHeight = (height + divider - 1) / divider;
+    ctx->sums.assign((size_t) ctx->outputWidth * ctx->outputHeight * 4, 0);
+    return true;
+}
+void ImageDownscaler::AddPixel(uint32 x, uint32 y, Pixel px)
+{
+    auto ctx = reinterpret_cast<DownscalerContext*>(context);
+    if ((!ctx) || (x >= ctx->width) || (y >= ctx->height))
+        return;
+    auto s = ctx->sums.data() + ((size_t) (y / ctx->divider) * ctx->outputWidth + x / ctx->divider) * 4;
+    s[0] += px.Blue;
+    s[1] += px.Green;
+    s[2] += px.Red;
+    s[3] += px.Alpha;
+}
+void ImageDownscaler::AddRow(uint32 y, const Pixel* row, uint32 count)
+{
+    auto ctx = reinterpret_cast<DownscalerContext*>(context);
+    if ((!ctx) || (y >= ctx->height))
+        return;
+    count  = std::min<>(count, ctx->width);
+    auto s = ctx->sums.data() + (size_t) (y / ctx->divider) * ctx->outputWidth * 4;
+    for (uint32 x = 0; x < count; s += 4)
+    {
+        // a whole block of `divider` pixels is added to the same accumulator
+        const auto end = std::min<>(x + ctx->divider, count);
+        for (; x < end; x++)
+        {
+            s[0] += row[x].Blue;
+            s[1] += row[x].Green;
+            s[2] += row[x].Red;
+            s[3] += row[x].Alpha;
+        }
+    }
+}
+bool ImageDownscaler::Finish(Image& img)
+{
+    auto ctx = reinterpret_cast<DownscalerContext*>(context);
+    CHECK(ctx, false, "Downscaler was not initialized");
+    CHECK(img.Create(ctx->outputWidth, ctx->outputHeight), false, "Fail to create a %u x %u image", ctx->outputWidth, ctx->outputHeight);
+
+    const uint32* s = ctx->sums.data();
+    for (uint32 y = 0; y < ctx->outputHeight; y++)
+    {
+        // blocks from the right and bottom edges can be smaller than divider x divider
+        const uint32 blockHeight = std::min<>(ctx->divider, ctx->height - y * ctx->divider);
+        for (uint32 x = 0; x < ctx->outputWidth; x++, s += 4)
+        {
+            const uint32 count = blockHeight * std::min<>(ctx->divider, ctx->width - x * ctx->divider);
+            img.SetPixel(x, y, Pixel((uint8) (s[2] / count), (uint8) (s[1] / count), (uint8) (s[0] / count), (uint8) (s[3] / count)));
+        }
+    }
+    ctx->sums.clear();
+    ctx->sums.shrink_to_fit();
+    return true;
+}
+uint32 ImageDownscaler::GetDivider() const
+{
+    auto ctx = reinterpret_cast<DownscalerContext*>(context);
+    return ctx ? ctx->divider : 1;
+}
@@ -47,7 +47,7 @@ namespace View
             void Initialize();
         };
 
-        class Instance : public View::ViewControl
+        class Instance : public View::ViewControl, public LoadImageProgressInterface
         {
             Image img;
             Pointer<SettingsData> settings;
@@ -55,15 +55,19 @@ namespace View
             Reference<GView::Object> obj;
             uint32 currentImageIndex;
             ImageScaleMethod scale;
+            ImageScaleMethod imgScale; // scale at which `img` was loaded (NoScale = full resolution)
+            bool scaledLoading;        // false if the plugin can not load reduced images
 
             static Config config;
 
             void LoadImage();
             void RedrawImage();
+            void SetScale(ImageScaleMethod newScale);
             ImageScaleMethod NextPreviousScale(bool next);
           public:
             Instance(Reference<GView::Object> obj, Settings* settings);
 
+            virtual void OnStart() override;
             virtual bool OnUpdateCommandBar(AppCUI::Application::CommandBar& commandBar) override;
             virtual bool OnKeyEvent(AppCUI::Input::Key keyCode, char16 characterCode) override;
             virtual bool OnEvent(Reference<Control>, Event eventType, int ID) override;
@@ -76,6 +80,8 @@ namespace View
 
             virtual void PaintCursorInformation(AppCUI::Graphics::Renderer& renderer, uint32 width, uint32 height) override;
 
+            bool OnImageLoadProgress(Image& img, uint32 step, uint32 stepsCount) override;
+
 
             // property interface
             bool GetPropertyValue(uint32 id, PropertyValue& value) override;
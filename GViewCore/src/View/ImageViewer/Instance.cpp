@@ -15,6 +15,8 @@ Instance::Instance(Reference<GView::Object> _obj, Settings* _settings) : setting
     this->obj               = _obj;
     this->currentImageIndex = 0;
     this->scale             = ImageScaleMethod::NoScale;
+    this->imgScale          = ImageScaleMethod::NoScale;
+    this->scaledLoading     = true;
     // settings
     if ((_settings) && (_settings->data))
     {
@@ -31,7 +33,10 @@ Instance::Instance(Reference<GView::Object> _obj, Settings* _settings) : setting
     if (config.Loaded == false)
         config.Initialize();
 
-    // load first image
+    // the first image is loaded by OnStart, once the view is part of a window (so that its coarse preview can be seen)
+}
+void Instance::OnStart()
+{
     LoadImage();
 }
 ImageScaleMethod Instance::NextPreviousScale(bool next)
@@ -58,14 +63,50 @@ ImageScaleMethod Instance::NextPreviousScale(bool next)
 }
 void Instance::RedrawImage()
 {
-    this->imgView->SetImage(this->img, ImageRenderingMethod::PixelTo16ColorsSmallBlock, scale);
+    // an image that was already reduced by the plugin is displayed as it is
+    if (this->imgScale != ImageScaleMethod::NoScale)
+        this->imgView->SetImage(this->img, ImageRenderingMethod::PixelTo16ColorsSmallBlock, ImageScaleMethod::NoScale);
+    else
+        this->imgView->SetImage(this->img, ImageRenderingMethod::PixelTo16ColorsSmallBlock, scale);
+}
+void Instance::SetScale(ImageScaleMethod newScale)
+{
+    this->scale = newScale;
+    if ((this->scaledLoading) && (this->imgScale != this->scale))
+        LoadImage();
+    else
+        RedrawImage();
 }
 void Instance::LoadImage()
 {
-    if (this->settings->loadImageCallback->LoadImageToObject(this->img, this->currentImageIndex))
+    // zoomed out views are requested directly at the displayed size (if the plugin supports it)
+    if ((this->scaledLoading) && (this->scale != ImageScaleMethod::NoScale))
+    {
+        if (this->settings->loadImageCallback->LoadImageToObjectScaled(this->img, this->currentImageIndex, (uint32) this->scale))
+        {
+            this->imgScale = this->scale;
+            RedrawImage();
+            return;
+        }
+        this->scaledLoading = false;
+    }
+    this->imgScale = ImageScaleMethod::NoScale;
+    if (this->settings->loadImageCallback->LoadImageToObjectProgressive(this->img, this->currentImageIndex, this))
+    {
+        RedrawImage();
+    }
+}
+bool Instance::OnImageLoadProgress(Image& image, uint32 step, uint32 stepsCount)
+{
+    // only the first partially loaded image (coarse preview) is displayed, the progress window repaints the screen;
+    // the next steps are not copied to the image view (the complete image is displayed by LoadImage)
+    LocalString<64> tmp;
+    if (step <= 1)
     {
+        AppCUI::Graphics::ProgressStatus::Init("Loading image", stepsCount);
         RedrawImage();
     }
+    return AppCUI::Graphics::ProgressStatus::Update(step, tmp.Format("Step %u of %u", step, stepsCount)) == false;
 }
 bool Instance::OnUpdateCommandBar(AppCUI::Application::CommandBar& commandBar)
 {
@@ -103,13 +144,11 @@ bool Instance::OnKeyEvent(AppCUI::Input::Key keyCode, char16 characterCode)
     {
     case '+':
     case '=':
-        this->scale = NextPreviousScale(true);
-        this->RedrawImage();
+        this->SetScale(NextPreviousScale(true));
         return true;
     case '-':
     case '_':
-        this->scale = NextPreviousScale(false);
-        this->RedrawImage();
+        this->SetScale(NextPreviousScale(false));
         return true;
     }
 
@@ -122,12 +161,10 @@ bool Instance::OnEvent(Reference<Control>, Event eventType, int ID)
     switch (ID)
     {
     case CMD_ID_ZOOMIN:
-        this->scale = NextPreviousScale(true);
-        this->RedrawImage();
+        this->SetScale(NextPreviousScale(true));
         return true;
     case CMD_ID_ZOOMOUT:
-        this->scale = NextPreviousScale(false);
-        this->RedrawImage();
+        this->SetScale(NextPreviousScale(false));
         return true;
     case CMD_ID_PREV_IMAGE:
         if (this->currentImageIndex > 0)
@@ -245,8 +282,7 @@ bool Instance::SetPropertyValue(uint32 id, const PropertyValue& value, String& e
     switch (static_cast<PropertyID>(id))
     {
     case PropertyID::Scale:
-        this->scale = static_cast<ImageScaleMethod>(std::get<uint64>(value));
-        this->RedrawImage();
+        this->SetScale(static_cast<ImageScaleMethod>(std::get<uint64>(value)));
         return true;
     case PropertyID::CurrentImageIndex:
         if ((std::get<uint32>(value)) >= this->settings->imgList.size())
@@ -479,6 +479,8 @@ namespace App
         GView::Type::Plugin defaultPlugin;
         GView::Utils::ErrorList errList;
         uint32 defaultCacheSize;
+        bool mapFiles;     // regular files are memory mapped instead of being read with positional reads
+        bool batchedReads; // the positional reads of the background reader are batched (io_uring)
         std::filesystem::path lastOpenedFolderLocation;
 
         bool BuildMainMenus();
@@ -624,8 +626,13 @@ namespace App
 
     class FileWindowProperties : public Window
     {
+        Reference<GView::Object> object;
+
+        void AddCacheStatistics(Reference<TabPage> page);
+        void SaveCacheStatistics();
+
       public:
-        FileWindowProperties(Reference<Tab> viewContainer);
+        FileWindowProperties(Reference<Tab> viewContainer, Reference<GView::Object> object);
         bool OnEvent(Reference<Control>, Event eventType, int) override;
     };
 
@@ -351,5 +351,10 @@ struct Finding {
     ArtefactType artefact{ ArtefactType::None };
 };
 
+struct OffsetRange {
+    uint64 start; // first offset
+    uint64 end;   // after the last offset
+};
+
 typedef ArtefactType (*ArtefactIdentificationCallback)(GView::Utils::DataCache& d, Subcategory subcategory, uint64 start, uint64 end, Result result);
 } // namespace GView::GenericPlugins::Droppper
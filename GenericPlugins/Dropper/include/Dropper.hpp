@@ -15,6 +15,8 @@
 #include "Images.hpp"
 #include "Archives.hpp"
 #include "Cryptographic.hpp"
+#include "Search.hpp"
+#include "Output.hpp"
 
 using namespace GView::Utils;
 using namespace GView::GenericPlugins::Droppper::SpecialStrings;
@@ -73,9 +75,16 @@ class Instance
 
     inline static constexpr uint32 SEPARATOR_LENGTH = 80;
 
+    // files with at least 2 shards are searched on all the cores
+    inline static constexpr uint64 MIN_SHARD_SIZE    = 0x800000; // 8 MB
+    inline static constexpr uint32 SHARDS_PER_THREAD = 4;
+
   private:
     bool ProcessBinaryDataCharset(std::string_view include, std::string_view exclude);
     bool FillCharSetMatrix(bool binaryCharSetMatrix[BINARY_CHARSET_MATRIX_SIZE], std::string_view s, bool value);
+    bool ProcessObjectsInParallel(const std::vector<IDrop*>& droppers, uint64 offset, uint64 size, bool recursive, ArtefactIdentificationCallback identify);
+    void AddFindings(const ObjectsSearch& search, size_t firstStep, ArtefactIdentificationCallback identify);
+    uint32 GetObjectsCount() const;
 
   public:
     Instance() = default;
@@ -86,7 +95,7 @@ class Instance
     std::optional<std::ofstream> InitLogFile(const std::filesystem::path& p, const std::vector<std::pair<uint64, uint64>>& areas, bool noHeader = false);
     bool WriteSummaryToLog(std::ofstream& f, std::map<std::string_view, uint32>& occurences);
     bool WriteToLog(std::ofstream& f, uint64 start, uint64 end, Result result, std::unique_ptr<IDrop>& dropper, bool addValue = false, bool writeValueOnly = false);
-    bool WriteToFile(std::filesystem::path path, uint64 start, uint64 end, std::unique_ptr<IDrop>& dropper, Result result);
+    bool WriteToFile(OutputWriter& output, std::filesystem::path path, uint64 start, uint64 end, std::unique_ptr<IDrop>& dropper, Result result);
     bool DropObjects(
           const std::vector<PluginClassification>& plugins,
           const std::filesystem::path& path,
@@ -16,6 +16,7 @@ class MZPE : public IDrop
     virtual const std::string_view GetOutputExtension() const override;
     virtual Priority GetPriority() const override;
     virtual bool ShouldGroupInOneFile() const override;
+    virtual std::vector<std::string_view> GetSignatures() const override;
 
     virtual bool Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding) override;
 };
@@ -15,6 +15,7 @@ class IFrame : public IDrop
     virtual const std::string_view GetOutputExtension() const override;
     virtual Priority GetPriority() const override;
     virtual bool ShouldGroupInOneFile() const override;
+    virtual std::vector<std::string_view> GetSignatures() const override;
 
     virtual bool Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding) override;
 };
@@ -29,6 +30,7 @@ class PHP : public IDrop
     virtual const std::string_view GetOutputExtension() const override;
     virtual Priority GetPriority() const override;
     virtual bool ShouldGroupInOneFile() const override;
+    virtual std::vector<std::string_view> GetSignatures() const override;
 
     virtual bool Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding) override;
 };
@@ -43,6 +45,7 @@ class Script : public IDrop
     virtual const std::string_view GetOutputExtension() const override;
     virtual Priority GetPriority() const override;
     virtual bool ShouldGroupInOneFile() const override;
+    virtual std::vector<std::string_view> GetSignatures() const override;
 
     virtual bool Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding) override;
 };
@@ -57,6 +60,7 @@ class XML : public IDrop // TODO: maybe a proper XML parser
     virtual const std::string_view GetOutputExtension() const override;
     virtual Priority GetPriority() const override;
     virtual bool ShouldGroupInOneFile() const override;
+    virtual std::vector<std::string_view> GetSignatures() const override;
 
     virtual bool Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding) override;
 };
@@ -17,7 +17,39 @@ class IDrop
     virtual Priority GetPriority() const                      = 0; // get plugin priority
     virtual bool ShouldGroupInOneFile() const                 = 0; // URLs, IPs, etc
 
+    // byte sequences (max 8 bytes) that every object found by Check starts with: Check is called only at the offsets where
+    // one of them is found; without signatures Check is called at every offset
+    virtual std::vector<std::string_view> GetSignatures() const
+    {
+        return {};
+    }
+
+    // regular expressions that the objects found by Check match from their first byte: they are searched together in the
+    // entire range (GetSignatures is not used) and Check is called only at the offsets where one of them matches
+    virtual std::vector<std::string_view> GetExpressions() const
+    {
+        return {};
+    }
+    // number of bytes (starting with the checked offset) that Check matches the expressions against
+    virtual uint32 GetExpressionsWindow(DataCache& file) const
+    {
+        return 0;
+    }
+
+    // droppers without signatures or expressions that can tell in a single pass over a chunk the offsets where their objects
+    // can start: the ranges of such offsets found in [from, to) of data (data continues with at least GetCandidatesWindow
+    // bytes or up to the end of the object) are stored in order in ranges and Check is called only there
+    virtual void GetCandidates(BufferView data, uint64 dataOffset, uint64 from, uint64 to, std::vector<OffsetRange>& ranges) const
+    {
+    }
+    // number of bytes after an offset that GetCandidates reads to decide it, 0 if the dropper does not find candidates
+    virtual uint32 GetCandidatesWindow() const
+    {
+        return 0;
+    }
+
     // prechachedBufferSize -> max 8
+    // called from several threads at once (parallel search), must not change the state of the dropper
     virtual bool Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding) = 0;
 
     // helpers
@@ -16,6 +16,7 @@ class PNG : public IDrop
     virtual const std::string_view GetOutputExtension() const override;
     virtual Priority GetPriority() const override;
     virtual bool ShouldGroupInOneFile() const override;
+    virtual std::vector<std::string_view> GetSignatures() const override;
 
     virtual bool Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding) override;
 };
@@ -32,6 +33,7 @@ class JPG : public IDrop
     virtual const std::string_view GetOutputExtension() const override;
     virtual Priority GetPriority() const override;
     virtual bool ShouldGroupInOneFile() const override;
+    virtual std::vector<std::string_view> GetSignatures() const override;
 
     virtual bool Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding) override;
 };
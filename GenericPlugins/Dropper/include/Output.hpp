@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include <map>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace GView::Utils;
+
+namespace GView::GenericPlugins::Droppper
+{
+// the files of the dropped objects: the data is collected in large buffers that are written on a background thread, so the
+// search results are written with a few large writes (and the files are opened and closed) while the next ones are read
+class OutputWriter
+{
+  public:
+    static constexpr uint32 BUFFER_SIZE        = 0x100000; // 1 MB
+    static constexpr uint32 MAX_QUEUED_BUFFERS = 16;       // the reader waits for the writer when more are queued
+
+  private:
+    struct File {
+        std::filesystem::path path;
+        bool append;
+        bool closed;               // no more data is added
+        std::vector<uint8> buffer; // collected data, not queued yet
+        std::ofstream stream;      // used only by the writer thread
+    };
+    struct Job {
+        File* file;
+        std::vector<uint8> data;
+        bool close;
+    };
+
+    std::vector<std::unique_ptr<File>> files;
+    std::map<std::filesystem::path, uint32> appended; // the files opened for appending are shared and stay open
+
+    std::deque<Job> jobs;
+    std::vector<std::vector<uint8>> spare; // written buffers, reused
+    std::mutex lock;
+    std::condition_variable changed;
+    std::thread writer;
+    bool stopping;
+    bool failed;
+
+    bool Submit(File& file, bool close);
+    void WriteJobs();
+
+  public:
+    OutputWriter();
+    ~OutputWriter();
+
+    // the files opened for appending are shared (the same path gives the same file) and closed by Finish, the other ones
+    // are truncated and closed by Close
+    std::optional<uint32> Open(const std::filesystem::path& path, bool append);
+    bool Write(uint32 file, BufferView data);
+    // [start, end) of cache is read in chunks (it can be larger than the cache), only the low byte of every UTF-16
+    // character is written when skipHighBytes is set
+    bool Write(uint32 file, DataCache& cache, uint64 start, uint64 end, bool skipHighBytes);
+    bool Close(uint32 file);
+    // writes all the data, closes the files and returns false if any of them could not be opened or written
+    bool Finish();
+};
+} // namespace GView::GenericPlugins::Droppper
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Signatures.hpp"
+
+#include <functional>
+#include <filesystem>
+
+using namespace GView::Utils;
+
+namespace GView::GenericPlugins::Droppper
+{
+// a search of the droppers over a range of a DataCache: the serial search and every shard of a parallel one
+// the result depends only on the data and on the offset the search starts at, so the shards searched on other threads (with
+// their own caches) can be merged into the same findings as a serial search
+class ObjectsSearch
+{
+  public:
+    struct Step {
+        uint64 position;     // offset where objects were found
+        uint64 next;         // offset where the search continued (the end of the object when the search is not recursive)
+        size_t firstFinding; // the findings of this offset are [firstFinding, next step firstFinding)
+    };
+    // called every PROGRESS_STEP bytes with the current offset, the search stops when it returns false
+    using Progress = std::function<bool(uint64 position)>;
+
+    static constexpr uint64 PROGRESS_STEP = 10000;
+
+    std::vector<Step> steps;
+    std::vector<Finding> findings;
+
+  private:
+    std::vector<IDrop*> droppers; // priority order is kept
+    SignatureIndex signatures;
+    ExpressionIndex expressions;
+    CandidateIndex candidateRanges;
+    uint32 overlap;
+    uint64 everyOffsetDroppers;
+    bool recursive;
+
+    uint64 ProcessOffset(uint64 position, DataCache& cache, BufferView buffer, uint64 candidates);
+
+  public:
+    ObjectsSearch();
+
+    // the droppers are shared between searches (Check has to be thread safe), the indexes are not
+    bool Init(const std::vector<IDrop*>& droppers, DataCache& cache, bool recursive);
+    // checks the offsets in [offset, end) and returns the offset where the search stopped: at least end or, if it was
+    // stopped by progress, the first offset that was not checked
+    uint64 Run(DataCache& cache, uint64 offset, uint64 end, const Progress& progress);
+    void Clear();
+};
+
+// a search of a file split in shards that are searched on several threads, the findings are reported in offset order and are
+// the same as the ones of a serial search of the cache of the object
+class ParallelObjectsSearch
+{
+  public:
+    // called on the calling thread with the offset reached and the objects found so far, the search stops when it returns false
+    using Progress = std::function<bool(uint64 position, uint32 found)>;
+    // the findings of search, starting with the ones of the step firstStep
+    using AddFindings = std::function<void(const ObjectsSearch& search, size_t firstStep)>;
+
+  private:
+    const std::vector<IDrop*>& droppers;
+    bool recursive;
+
+  public:
+    ParallelObjectsSearch(const std::vector<IDrop*>& droppers, bool recursive);
+
+    // every worker reads the file through its own cache, with the same size as the cache of the object (the droppers read
+    // windows that depend on it)
+    bool Run(
+          DataCache& cache,
+          const std::filesystem::path& path,
+          uint64 offset,
+          uint64 end,
+          uint32 threads,
+          uint32 shardsCount,
+          const Progress& progress,
+          const AddFindings& addFindings);
+};
+} // namespace GView::GenericPlugins::Droppper
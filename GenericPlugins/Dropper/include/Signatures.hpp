@@ -0,0 +1,112 @@
+#pragma once
+
+#include "IDrop.hpp"
+
+using namespace GView::Utils;
+
+namespace GView::GenericPlugins::Droppper
+{
+// the signatures declared by the droppers, indexed by their first byte: a single table lookup per byte skips the offsets
+// where no signature can start and the remaining candidates are confirmed by comparing the entire signature
+class SignatureIndex
+{
+  private:
+    struct Entry {
+        std::string_view signature;
+        uint32 dropper;
+    };
+
+    std::vector<Entry> entries[256];
+    bool firstBytes[256];
+    uint32 maxLength;
+
+  public:
+    static constexpr uint32 MAX_DROPPERS = 64;
+
+    SignatureIndex();
+
+    // dropper -> index (less than MAX_DROPPERS) reported by Match, signatures are compared against the precached buffer
+    bool Add(std::string_view signature, uint32 dropper);
+    // number of bytes from the start of data that can be skipped (no signature starts there)
+    size_t Skip(const uint8* data, size_t size) const;
+    // bit mask with the droppers that have a signature at the start of data
+    uint64 Match(BufferView data) const;
+
+    inline uint32 GetMaxLength() const
+    {
+        return maxLength;
+    }
+};
+
+// the regular expressions declared by the droppers, searched together once per chunk (a single pass of a combined automaton
+// tells which of them match in it): the offsets where they match are collected in order with the droppers that match there
+class ExpressionIndex
+{
+  private:
+    struct Hit {
+        uint64 offset;
+        uint64 droppers;
+    };
+
+    GView::Regex::MatcherSet set;
+    std::vector<uint32> droppers; // expression -> dropper
+    std::vector<uint32> matched;
+    std::vector<Hit> hits;
+    size_t next;
+
+  public:
+    ExpressionIndex();
+
+    // dropper -> index (less than SignatureIndex::MAX_DROPPERS) reported by Match
+    bool Add(std::string_view expression, uint32 dropper);
+    bool Compile();
+    // finds the matches that start in [from, to) of data (they can end anywhere in data), dataOffset is the offset of data
+    bool Scan(BufferView data, uint64 dataOffset, uint64 from, uint64 to);
+    // first offset (at least 'offset') where an expression matches or UINT64_MAX, the offsets must increase between two scans
+    uint64 GetNextOffset(uint64 offset);
+    // bit mask with the droppers that have an expression matching at offset
+    uint64 Match(uint64 offset);
+
+    inline bool IsEmpty() const
+    {
+        return droppers.empty();
+    }
+};
+
+// the droppers that find the offsets where their objects can start in a single pass over a chunk (IDrop::GetCandidates)
+class CandidateIndex
+{
+  private:
+    struct Source {
+        IDrop* dropper;
+        uint32 index;
+        std::vector<OffsetRange> ranges;
+        size_t next;
+    };
+
+    std::vector<Source> sources;
+    uint32 window;
+
+  public:
+    CandidateIndex();
+
+    // index (less than SignatureIndex::MAX_DROPPERS) reported by Match
+    bool Add(IDrop* dropper, uint32 index);
+    // finds the candidates in [from, to) of data, dataOffset is the offset of data
+    bool Scan(BufferView data, uint64 dataOffset, uint64 from, uint64 to);
+    // first candidate offset (at least 'offset') or UINT64_MAX, the offsets must increase between two scans
+    uint64 GetNextOffset(uint64 offset);
+    // bit mask with the droppers that have offset as a candidate
+    uint64 Match(uint64 offset);
+
+    inline bool IsEmpty() const
+    {
+        return sources.empty();
+    }
+    // number of bytes after the scanned range that the droppers read
+    inline uint32 GetWindow() const
+    {
+        return window;
+    }
+};
+} // namespace GView::GenericPlugins::Droppper
@@ -3,6 +3,7 @@
 #include "IDrop.hpp"
 
 #include <string>
+#include <atomic>
 
 namespace GView::GenericPlugins::Droppper::SpecialStrings
 {
@@ -48,11 +49,18 @@ class SpecialStrings : public IDrop
     bool caseSensitive{ false };
     GView::Regex::Matcher matcherAscii{};
     GView::Regex::Matcher matcherUnicode{};
+    std::string_view expressionAscii{};
+    std::string_view expressionUnicode{};
+
+    // the expressions are not anchored (they are searched in a range), the matchers are anchored at the checked offset
+    bool SetExpressions(std::string_view ascii, std::string_view unicode);
 
   public:
     virtual Category GetCategory() const override;
     virtual Priority GetPriority() const override;
     virtual bool ShouldGroupInOneFile() const override;
+    virtual std::vector<std::string_view> GetExpressions() const override;
+    virtual uint32 GetExpressionsWindow(DataCache& file) const override;
 };
 
 class IpAddress : public SpecialStrings
@@ -63,6 +71,7 @@ class IpAddress : public SpecialStrings
     virtual const std::string_view GetName() const override;
     virtual const std::string_view GetOutputExtension() const override;
     virtual Subcategory GetSubcategory() const override;
+    virtual uint32 GetExpressionsWindow(DataCache& file) const override;
 
     virtual bool Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding) override;
 };
@@ -102,7 +111,7 @@ class URL : public SpecialStrings
 class Wallet : public SpecialStrings
 {
   public:
-    WalletType checkResult{};
+    std::atomic<WalletType> checkResult{};
 
   public:
     Wallet(bool caseSensitive, bool unicode);
@@ -111,6 +120,7 @@ class Wallet : public SpecialStrings
     virtual const std::string_view GetOutputExtension() const override;
     virtual Subcategory GetSubcategory() const override;
 
+    virtual std::vector<std::string_view> GetSignatures() const override;
     virtual bool Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding) override;
 
     WalletType GetLastCheckResult() const;
@@ -130,11 +140,30 @@ class Registry : public SpecialStrings
 // text class has a separate purpose
 class Text : public SpecialStrings
 {
+  public:
+    // the charset in the forms used by the classifiers (blocks of BLOCK_SIZE bytes)
+    struct CharSet {
+        static constexpr uint32 MAX_RANGES = 4;
+
+        bool matrix[STRINGS_CHARSET_MATRIX_SIZE];
+        uint8 nibbles[2][16];        // bit h of nibbles[0][l] is set when h << 4 | l is in the charset, nibbles[1] for h + 8
+        uint8 ranges[MAX_RANGES][2]; // first and last byte of the ranges of the charset
+        uint32 rangesCount;          // 0 if the charset has more than MAX_RANGES ranges
+    };
+    // bit i of valid (zero) is set when data[i] is in the charset (is 0)
+    using ClassifyFunction = void (*)(const CharSet& charSet, const uint8* data, uint64& valid, uint64& zero);
+
+    static constexpr uint32 BLOCK_SIZE = 64;
+
   private:
     bool ascii{ false };
     uint32 minLength{ 8 };
     uint32 maxLength{ 128 };
-    bool stringsCharSetMatrix[STRINGS_CHARSET_MATRIX_SIZE]{};
+    CharSet charSet{};
+    ClassifyFunction classify{ nullptr };
+
+    void Classify(const uint8* data, uint64 size, uint64& valid, uint64& zero) const;
+    uint64 CountValid(const uint8* data, uint64 size, bool isUnicode, uint64 limit) const;
 
   public:
     Text(bool caseSensitive, bool unicode);
@@ -143,6 +172,8 @@ class Text : public SpecialStrings
     virtual const std::string_view GetOutputExtension() const override;
     virtual Subcategory GetSubcategory() const override;
 
+    virtual void GetCandidates(BufferView data, uint64 dataOffset, uint64 from, uint64 to, std::vector<OffsetRange>& ranges) const override;
+    virtual uint32 GetCandidatesWindow() const override;
     virtual bool Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding) override;
 
     bool SetMinLength(uint32 minLength);
@@ -45,7 +45,7 @@ ArtefactsUI::ArtefactsUI(DataCache& cache, const std::vector<Finding>& findings)
             }
 
             auto& b        = this->entries.emplace_back(Buffer());
-            b              = cache.CopyToBuffer(f.start, static_cast<uint32>(f.end - f.start), true);
+            b              = cache.CopyToBuffer(f.start, f.end - f.start, true);
             const auto svp = n.ToString(f.start, { NumericFormatFlags::HexPrefix, 16 });
 
             std::string_view artefact = "-";
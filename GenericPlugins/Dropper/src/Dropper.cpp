@@ -5,6 +5,7 @@
 #include <array>
 #include <regex>
 #include <charconv>
+#include <thread>
 
 using namespace AppCUI;
 using namespace AppCUI::Utils;
@@ -125,10 +126,6 @@ bool Instance::WriteToLog(std::ofstream& f, uint64 start, uint64 end, Result res
     CHECK(f.is_open(), false, "");
 
     if (!writeValueOnly) {
-        auto& cache = this->object->GetData();
-        auto bv     = cache.Get(start, static_cast<uint32>(end - start), true);
-        CHECK(bv.IsValid(), false, "");
-
         f << std::setfill('0') << std::setw(8) << std::hex << std::uppercase << start << ": ";
         f << std::setfill(' ') << std::setw(8) << std::dec << (end - start) << " bytes -> [";
         f << std::setfill(' ') << std::setw(16) << dropper->GetName() << "] [";
@@ -140,70 +137,54 @@ bool Instance::WriteToLog(std::ofstream& f, uint64 start, uint64 end, Result res
         }
     }
 
-    if (addValue || writeValueOnly) {
+    if ((addValue || writeValueOnly) && (result == Result::Ascii || result == Result::Unicode)) {
+        // the value is streamed (it can be larger than the cache); chunks have an even size so UTF-16 characters are never split
         auto& cache = this->object->GetData();
-        auto bv     = cache.Get(start, static_cast<uint32>(end - start), true);
-        CHECK(bv.IsValid(), false, "");
-
-        switch (result) {
-        case GView::GenericPlugins::Droppper::Result::NotFound:
-            break;
-        case GView::GenericPlugins::Droppper::Result::Buffer:
-            break;
-        case GView::GenericPlugins::Droppper::Result::Ascii:
-            f.write(reinterpret_cast<const char*>(bv.GetData()), bv.GetLength());
-            break;
-        case GView::GenericPlugins::Droppper::Result::Unicode:
-            for (uint32 i = 0; i < bv.GetLength(); i += 2) {
-                f.write(reinterpret_cast<const char*>(bv.GetData() + i), 1);
+        auto chunks = cache.Chunks(start, end - start, cache.GetCacheSize());
+        for (const auto& chunk : chunks) {
+            if (result == Result::Unicode) {
+                for (uint32 i = 0; i < chunk.data.GetLength(); i += 2) {
+                    f.put(static_cast<char>(chunk.data[i]));
+                }
+            } else {
+                f.write(reinterpret_cast<const char*>(chunk.data.GetData()), chunk.data.GetLength());
             }
-            break;
-        default:
-            break;
         }
+        CHECK(chunks.HasFailed() == false, false, "");
     }
 
-    f << std::endl;
+    // no flush for every object, the log is written in large blocks
+    f << '\n';
 
     CHECK(f.good(), false, "");
 
     return true;
 }
 
-bool Instance::WriteToFile(std::filesystem::path path, uint64 start, uint64 end, std::unique_ptr<IDrop>& dropper, Result result)
+bool Instance::WriteToFile(OutputWriter& output, std::filesystem::path path, uint64 start, uint64 end, std::unique_ptr<IDrop>& dropper, Result result)
 {
-    auto bv = object->GetData().Get(start, static_cast<uint32>(end - start), true);
-    CHECK(bv.IsValid(), false, "");
+    auto& cache = object->GetData();
+    CHECK(start < end && end <= cache.GetSize(), false, "");
 
-    auto flags = std::ios::out | std::ios::binary;
-    if (dropper->ShouldGroupInOneFile()) {
+    // the objects grouped in one file are appended to a file that stays open, every other object has its own file
+    const bool grouped = dropper->ShouldGroupInOneFile();
+    if (grouped) {
         std::string f = path.filename().string().append(".").append(dropper->GetOutputExtension());
         path          = path.parent_path() / f;
-        flags |= std::ios::app;
     } else {
         std::string f = path.filename().string().append(".obj.").append(std::to_string(objectId++)).append(".").append(dropper->GetOutputExtension());
         path          = path.parent_path() / f;
     }
 
-    std::ofstream f;
-    f.open(path, flags);
-    CHECK(f.is_open(), false, "");
-
-    if (dropper->ShouldGroupInOneFile()) {
-        if (result == Result::Unicode) {
-            for (uint32 i = 0; i < bv.GetLength(); i += 2) {
-                f.write(reinterpret_cast<const char*>(bv.GetData() + i), 1);
-            }
-        } else {
-            f.write(reinterpret_cast<const char*>(bv.GetData()), bv.GetLength());
-        }
-        f.write("\n", 1);
+    const auto file = output.Open(path, grouped);
+    CHECK(file.has_value(), false, "");
+    CHECK(output.Write(*file, cache, start, end, grouped && result == Result::Unicode), false, "");
+    if (grouped) {
+        CHECK(output.Write(*file, BufferView("\n", 1)), false, "");
     } else {
-        f.write(reinterpret_cast<const char*>(bv.GetData()), bv.GetLength());
+        CHECK(output.Close(*file), false, "");
     }
 
-    f.close();
-
     context.objectPaths.insert(path);
 
     return true;
@@ -248,16 +229,19 @@ bool Instance::DropObjects(
 
         CHECK(logFile->good(), false, "");
 
+        // the objects are written on a background thread while the next ones are read
+        OutputWriter output;
         WriteSummaryToLog(*logFile, context.occurences);
         for (const auto& f : context.findings) {
             for (auto& dropper : context.objectDroppers) {
                 if (dropper->GetName() == f.dropperName) {
                     CHECK(WriteToLog(*logFile, f.start, f.end, f.result, dropper), false, "");
-                    CHECK(WriteToFile(path, f.start, f.end, dropper, f.result), false, "");
+                    CHECK(WriteToFile(output, path, f.start, f.end, dropper, f.result), false, "");
                     break;
                 }
             }
         }
+        CHECK(output.Finish(), false, "");
     }
 
     if (highlightObjects) {
@@ -270,104 +254,98 @@ bool Instance::DropObjects(
 bool Instance::ProcessObjects(
       const std::vector<PluginClassification>& plugins, uint64 offset, uint64 size, bool recursive, ArtefactIdentificationCallback identify)
 {
-    DataCache& cache  = object->GetData();
-    uint64 nextOffset = offset;
+    DataCache& cache = object->GetData();
+    DataCache::Tag tag(cache, "Dropper");
 
-    std::vector<std::unique_ptr<IDrop>*> whitelistedPlugins;
+    std::vector<IDrop*> whitelistedPlugins;
     whitelistedPlugins.reserve(context.objectDroppers.size());
     if (plugins.size() == 1 && context.textDropper->GetCategory() == plugins[0].category && context.textDropper->GetSubcategory() == plugins[0].subcategory) {
-        whitelistedPlugins.push_back(&context.textDropper);
+        whitelistedPlugins.push_back(context.textDropper.get());
     } else {
         for (auto& d : context.objectDroppers) {
             for (const auto& p : plugins) {
                 if (d->GetCategory() == p.category && d->GetSubcategory() == p.subcategory) {
-                    whitelistedPlugins.push_back(&d);
+                    whitelistedPlugins.push_back(d.get());
                     break;
                 }
             }
         }
     }
     if (identify != nullptr && plugins.size() > 1) {
-        whitelistedPlugins.push_back(&context.textDropper);
+        whitelistedPlugins.push_back(context.textDropper.get());
     }
 
     ProgressStatus::Init("Searching...", size);
     LocalString<512> ls;
-    const char* format          = "[%llu/%llu] bytes... Found [%u] object(s).";
-    constexpr uint64 CHUNK_SIZE = 10000;
-    uint64 chunks               = offset / CHUNK_SIZE;
-    uint64 toUpdate             = chunks * CHUNK_SIZE;
-    while (offset < size) {
-        if (offset >= toUpdate) {
-            uint32 objectsCount = 0;
-            for (const auto& [_, v] : context.occurences) {
-                objectsCount += v;
-            }
+    const char* format = "[%llu/%llu] bytes... Found [%u] object(s).";
 
-            CHECKBK(ProgressStatus::Update(offset, ls.Format(format, offset, size, objectsCount)) == false, "");
-            chunks += 1;
-            toUpdate = chunks * CHUNK_SIZE;
-
-            cache.Get(offset, cache.GetCacheSize(), false); // optimization
-        }
-
-        auto buffer = GetPrecachedBuffer(offset, cache);
-        CHECKBK(buffer.GetLength() > 0, "");
-        nextOffset = offset + 1;
+    const auto threads = std::thread::hardware_concurrency();
+    if (object->GetObjectType() == GView::Object::Type::File && threads > 1 && offset < size && size - offset >= 2 * MIN_SHARD_SIZE) {
+        CHECK(ProcessObjectsInParallel(whitelistedPlugins, offset, size, recursive, identify), false, "");
+    } else {
+        ObjectsSearch search;
+        CHECK(search.Init(whitelistedPlugins, cache, recursive), false, "");
 
-        for (uint32 i = 0; i < static_cast<uint32>(Priority::Count); i++) {
-            const auto priority = static_cast<Priority>(i);
-            if (priority == Priority::Text) {
-                if (!IDrop::IsAsciiPrintable(buffer.GetData()[0])) {
-                    continue;
-                }
-            }
+        const auto objectsCount = GetObjectsCount();
+        search.Run(cache, offset, size, [&](uint64 position) -> bool {
+            const auto found = objectsCount + static_cast<uint32>(search.findings.size());
+            CHECK(ProgressStatus::Update(position, ls.Format(format, position, size, found)) == false, false, "");
+            return true;
+        });
+        AddFindings(search, 0, identify);
+    }
 
-            for (auto& dropper : whitelistedPlugins) {
-                if ((*dropper)->GetPriority() != priority) {
-                    continue;
-                }
+    ProgressStatus::Update(size, ls.Format(format, size, size, GetObjectsCount()));
 
-                Finding finding{ .dropperName = (*dropper)->GetName(), .category = (*dropper)->GetCategory(), .subcategory = (*dropper)->GetSubcategory() };
-                const auto result = (*dropper)->Check(offset, cache, buffer, finding);
+    return true;
+}
 
-                if (result && finding.result != Result::NotFound) {
-                    auto& f = context.findings.emplace_back(finding);
-                    context.occurences[f.dropperName] += 1;
+bool Instance::ProcessObjectsInParallel(
+      const std::vector<IDrop*>& droppers, uint64 offset, uint64 size, bool recursive, ArtefactIdentificationCallback identify)
+{
+    const auto threads = std::max<uint32>(std::thread::hardware_concurrency(), 1);
+    const auto shards  = static_cast<uint32>(std::min<uint64>((size - offset) / MIN_SHARD_SIZE, threads * SHARDS_PER_THREAD));
 
-                    if (!recursive) {
-                        nextOffset = f.end;
-                    }
+    LocalString<512> ls;
+    const char* format      = "[%llu/%llu] bytes... Found [%u] object(s).";
+    const auto objectsCount = GetObjectsCount();
+    ParallelObjectsSearch search(droppers, recursive);
+    return search.Run(
+          object->GetData(),
+          object->GetPath(),
+          offset,
+          size,
+          threads,
+          shards,
+          [&](uint64 position, uint32 found) -> bool { return ProgressStatus::Update(position, ls.Format(format, position, size, objectsCount + found)) == false; },
+          [&](const ObjectsSearch& found, size_t firstStep) { AddFindings(found, firstStep, identify); });
+}
 
-                    // adjust for zones
-                    if (f.result == Result::Unicode) {
-                        f.end -= 2;
-                    } else if (f.result == Result::Ascii) {
-                        f.end -= 1;
-                    } else {
-                        f.end += 1;
-                    }
-                    context.zones.Add(f.start, f.end, OBJECT_CATEGORY_COLOR_MAP.at(f.category), f.dropperName);
+void Instance::AddFindings(const ObjectsSearch& search, size_t firstStep, ArtefactIdentificationCallback identify)
+{
+    if (firstStep >= search.steps.size()) {
+        return;
+    }
 
-                    if (identify != nullptr) {
-                        f.artefact = identify(cache, f.subcategory, f.start, f.end, f.result);
-                    }
+    auto& cache = object->GetData();
+    for (auto i = search.steps[firstStep].firstFinding; i < search.findings.size(); i++) {
+        auto& f = context.findings.emplace_back(search.findings[i]);
+        context.occurences[f.dropperName] += 1;
+        context.zones.Add(f.start, f.end, OBJECT_CATEGORY_COLOR_MAP.at(f.category), f.dropperName);
 
-                    break;
-                }
-            }
+        if (identify != nullptr) {
+            f.artefact = identify(cache, f.subcategory, f.start, f.end, f.result);
         }
-
-        offset = nextOffset;
     }
+}
 
+uint32 Instance::GetObjectsCount() const
+{
     uint32 objectsCount = 0;
     for (const auto& [_, v] : context.occurences) {
         objectsCount += v;
     }
-    ProgressStatus::Update(size, ls.Format(format, size, size, objectsCount));
-
-    return true;
+    return objectsCount;
 }
 
 bool Instance::SetHighlighting(bool value, bool warn)
@@ -199,6 +199,12 @@ bool MZPE::ShouldGroupInOneFile() const
     return false;
 }
 
+std::vector<std::string_view> MZPE::GetSignatures() const
+{
+    // the magic is compared in native byte order (IsMagicU16)
+    return { std::string_view(reinterpret_cast<const char*>(&IMAGE_DOS_SIGNATURE), sizeof(IMAGE_DOS_SIGNATURE)) };
+}
+
 bool MZPE::Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding)
 {
     CHECK(IsMagicU16(precachedBuffer, IMAGE_DOS_SIGNATURE), false, "");
@@ -209,28 +215,30 @@ bool MZPE::Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Fin
     auto dos = buffer.GetObject<ImageDOSHeader>();
     CHECK(dos, false, "");
     CHECK(dos->e_magic == IMAGE_DOS_SIGNATURE, false, "");
+    const auto lfanew = dos->e_lfanew; // the next Get invalidates the view that dos points in
 
-    buffer     = file.Get(offset, buffer.GetLength() + dos->e_lfanew + sizeof(ImageNTHeaders64), true);
-    auto nth32 = buffer.GetObject<ImageNTHeaders32>(dos->e_lfanew);
+    buffer     = file.Get(offset, buffer.GetLength() + lfanew + sizeof(ImageNTHeaders64), true);
+    auto nth32 = buffer.GetObject<ImageNTHeaders32>(lfanew);
     CHECK(nth32, false, "");
     CHECK(nth32->Signature == IMAGE_NT_SIGNATURE, false, "");
 
     const uint64 count   = nth32->FileHeader.NumberOfSections;
-    const auto position  = static_cast<uint64>(dos->e_lfanew) + nth32->FileHeader.SizeOfOptionalHeader + sizeof(nth32->Signature) + sizeof(ImageFileHeader);
+    const auto position  = static_cast<uint64>(lfanew) + nth32->FileHeader.SizeOfOptionalHeader + sizeof(nth32->Signature) + sizeof(ImageFileHeader);
     auto dataDirectories = &nth32->OptionalHeader.DataDirectory[0];
 
     if (nth32->OptionalHeader.Magic == __IMAGE_NT_OPTIONAL_HDR64_MAGIC) {
-        auto nth64 = buffer.GetObject<ImageNTHeaders64>(dos->e_lfanew);
+        auto nth64 = buffer.GetObject<ImageNTHeaders64>(lfanew);
         CHECK(nth64, false, "");
         CHECK(nth64->Signature == IMAGE_NT_SIGNATURE, false, "");
         dataDirectories = &nth64->OptionalHeader.DataDirectory[0];
     }
     CHECK(dataDirectories, false, "");
+    const auto sec = dataDirectories[(uint8) DirectoryType::Security];
 
     auto b   = file.Get(offset + position + (count - 1) * sizeof(ImageSectionHeader), sizeof(ImageSectionHeader), true);
     auto obj = b.GetObject<ImageSectionHeader>(0);
+    CHECK(obj, false, "");
 
-    const auto sec = dataDirectories[(uint8) DirectoryType::Security];
     const auto computedSize =
           std::max<uint64>(static_cast<uint64>(obj->PointerToRawData) + obj->SizeOfRawData, static_cast<uint64>(sec.VirtualAddress) + sec.Size);
 
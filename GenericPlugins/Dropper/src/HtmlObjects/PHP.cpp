@@ -35,6 +35,11 @@ bool PHP::ShouldGroupInOneFile() const
     return false;
 }
 
+std::vector<std::string_view> PHP::GetSignatures() const
+{
+    return { START };
+}
+
 bool PHP::Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding)
 {
     CHECK(precachedBuffer.GetLength() >= START.size(), false, "");
@@ -35,6 +35,11 @@ bool XML::ShouldGroupInOneFile() const
     return false;
 }
 
+std::vector<std::string_view> XML::GetSignatures() const
+{
+    return { START };
+}
+
 bool XML::Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding)
 {
     CHECK(precachedBuffer.GetLength() >= START.size(), false, "");
@@ -34,6 +34,12 @@ bool JPG::ShouldGroupInOneFile() const
     return false;
 }
 
+std::vector<std::string_view> JPG::GetSignatures() const
+{
+    // the magic is compared in native byte order (IsMagicU16)
+    return { std::string_view(reinterpret_cast<const char*>(&IMAGE_JPG_MAGIC_SOI), sizeof(IMAGE_JPG_MAGIC_SOI)) };
+}
+
 bool JPG::Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding)
 {
     CHECK(IsMagicU16(precachedBuffer, IMAGE_JPG_MAGIC_SOI), false, "");
@@ -35,6 +35,12 @@ bool PNG::ShouldGroupInOneFile() const
     return false;
 }
 
+std::vector<std::string_view> PNG::GetSignatures() const
+{
+    // the magic is compared in native byte order (IsMagicU64)
+    return { std::string_view(reinterpret_cast<const char*>(&IMAGE_PNG_MAGIC), sizeof(IMAGE_PNG_MAGIC)) };
+}
+
 bool PNG::Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding)
 {
     CHECK(IsMagicU64(precachedBuffer, IMAGE_PNG_MAGIC), false, "");
@@ -0,0 +1,189 @@
+#include "Output.hpp"
+
+namespace GView::GenericPlugins::Droppper
+{
+OutputWriter::OutputWriter()
+{
+    stopping = false;
+    failed   = false;
+}
+
+OutputWriter::~OutputWriter()
+{
+    Finish();
+}
+
+std::optional<uint32> OutputWriter::Open(const std::filesystem::path& path, bool append)
+{
+    CHECK(!stopping, std::nullopt, "");
+    if (append) {
+        const auto it = appended.find(path);
+        if (it != appended.end()) {
+            return it->second;
+        }
+    }
+
+    if (!writer.joinable()) {
+        writer = std::thread(&OutputWriter::WriteJobs, this);
+    }
+
+    auto file    = std::make_unique<File>();
+    file->path   = path;
+    file->append = append;
+    file->closed = false;
+
+    const auto id = static_cast<uint32>(files.size());
+    files.push_back(std::move(file));
+    if (append) {
+        appended[path] = id;
+    }
+
+    return id;
+}
+
+bool OutputWriter::Write(uint32 id, BufferView data)
+{
+    CHECK(id < files.size(), false, "");
+    auto& file = *files[id];
+    CHECK(!file.closed, false, "");
+
+    auto p      = data.GetData();
+    size_t size = data.GetLength();
+    while (size > 0) {
+        const auto count = std::min<size_t>(size, BUFFER_SIZE - file.buffer.size());
+        file.buffer.insert(file.buffer.end(), p, p + count);
+        p += count;
+        size -= count;
+        if (file.buffer.size() >= BUFFER_SIZE) {
+            CHECK(Submit(file, false), false, "");
+        }
+    }
+
+    return true;
+}
+
+bool OutputWriter::Write(uint32 id, DataCache& cache, uint64 start, uint64 end, bool skipHighBytes)
+{
+    CHECK(id < files.size(), false, "");
+    CHECK(start <= end, false, "");
+    auto& file = *files[id];
+
+    // chunks have an even size so UTF-16 characters are never split
+    auto chunks = cache.Chunks(start, end - start, cache.GetCacheSize());
+    for (const auto& chunk : chunks) {
+        if (!skipHighBytes) {
+            CHECK(Write(id, chunk.data), false, "");
+            continue;
+        }
+
+        const auto data = chunk.data.GetData();
+        const auto size = static_cast<size_t>(chunk.data.GetLength());
+        for (size_t i = 0; i < size;) {
+            const auto count = std::min<size_t>((size - i + 1) / 2, BUFFER_SIZE - file.buffer.size());
+            const auto used  = file.buffer.size();
+            file.buffer.resize(used + count);
+            for (size_t j = 0; j < count; j++, i += 2) {
+                file.buffer[used + j] = data[i];
+            }
+            if (file.buffer.size() >= BUFFER_SIZE) {
+                CHECK(Submit(file, false), false, "");
+            }
+        }
+    }
+    CHECK(chunks.HasFailed() == false, false, "");
+
+    return true;
+}
+
+bool OutputWriter::Close(uint32 id)
+{
+    CHECK(id < files.size(), false, "");
+    auto& file = *files[id];
+    CHECK(!file.closed, false, "");
+
+    file.closed = true;
+    return Submit(file, true);
+}
+
+bool OutputWriter::Finish()
+{
+    if (!writer.joinable()) {
+        return !failed;
+    }
+
+    bool result = true;
+    for (auto& file : files) {
+        if (!file->closed) {
+            file->closed = true;
+            result       = Submit(*file, true) && result;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    changed.notify_all();
+    writer.join();
+
+    return result && !failed;
+}
+
+// queues the collected data of a file (the reader waits while the writer is MAX_QUEUED_BUFFERS behind)
+bool OutputWriter::Submit(File& file, bool close)
+{
+    std::unique_lock<std::mutex> guard(lock);
+    changed.wait(guard, [this]() { return jobs.size() < MAX_QUEUED_BUFFERS || failed; });
+    CHECK(!failed, false, "");
+
+    jobs.push_back({ &file, std::move(file.buffer), close });
+    file.buffer.clear();
+    if (!close && !spare.empty()) {
+        file.buffer = std::move(spare.back());
+        spare.pop_back();
+    }
+    guard.unlock();
+    changed.notify_all();
+
+    return true;
+}
+
+// runs on the writer thread: a file is opened with its first data and stays open until the job that closes it
+void OutputWriter::WriteJobs()
+{
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            changed.wait(guard, [this]() { return !jobs.empty() || stopping; });
+            if (jobs.empty()) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        changed.notify_all();
+
+        auto& stream = job.file->stream;
+        if (!stream.is_open()) {
+            stream.open(job.file->path, std::ios::out | std::ios::binary | (job.file->append ? std::ios::app : std::ios::trunc));
+        }
+        stream.write(reinterpret_cast<const char*>(job.data.data()), job.data.size());
+        if (job.close) {
+            stream.close();
+        }
+        const auto good = !stream.fail();
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            failed = failed || !good;
+            if (job.data.capacity() >= BUFFER_SIZE && spare.size() < MAX_QUEUED_BUFFERS) {
+                job.data.clear();
+                spare.push_back(std::move(job.data));
+            }
+        }
+        if (!good) {
+            changed.notify_all();
+        }
+    }
+}
+} // namespace GView::GenericPlugins::Droppper
@@ -0,0 +1,335 @@
+#include "Search.hpp"
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+namespace GView::GenericPlugins::Droppper
+{
+ObjectsSearch::ObjectsSearch()
+{
+    overlap             = 0;
+    everyOffsetDroppers = 0;
+    recursive           = false;
+}
+
+bool ObjectsSearch::Init(const std::vector<IDrop*>& _droppers, DataCache& cache, bool _recursive)
+{
+    CHECK(this->droppers.empty(), false, "");
+    CHECK(_droppers.size() <= SignatureIndex::MAX_DROPPERS, false, "");
+    this->droppers  = _droppers;
+    this->recursive = _recursive;
+
+    // the droppers with signatures (or expressions, candidates) are checked only where one of their signatures starts (or
+    // expressions match, candidates were found), the other ones at every offset
+    uint32 expressionsWindow = 0;
+    for (uint32 i = 0; i < static_cast<uint32>(droppers.size()); i++) {
+        const auto dropper  = droppers[i];
+        const auto patterns = dropper->GetExpressions();
+        if (!patterns.empty()) {
+            for (const auto& expression : patterns) {
+                CHECK(expressions.Add(expression, i), false, "");
+            }
+            expressionsWindow = std::max<uint32>(expressionsWindow, dropper->GetExpressionsWindow(cache));
+            continue;
+        }
+        if (dropper->GetCandidatesWindow() > 0) {
+            CHECK(candidateRanges.Add(dropper, i), false, "");
+            continue;
+        }
+
+        const auto list = dropper->GetSignatures();
+        if (list.empty()) {
+            everyOffsetDroppers |= 1ULL << i;
+        }
+        for (const auto& signature : list) {
+            CHECK(signatures.Add(signature, i), false, "");
+        }
+    }
+    if (!expressions.IsEmpty()) {
+        CHECK(expressions.Compile(), false, "");
+    }
+
+    // the chunks overlap so that a signature or the data an expression is matched against (or a candidate is decided on) is
+    // never split between two of them
+    overlap = std::max<uint32>({ signatures.GetMaxLength() > 0 ? signatures.GetMaxLength() - 1 : 0, expressionsWindow, candidateRanges.GetWindow() });
+
+    return true;
+}
+
+void ObjectsSearch::Clear()
+{
+    steps.clear();
+    findings.clear();
+}
+
+// runs the candidate droppers (priority order) and returns the offset where the search continues
+uint64 ObjectsSearch::ProcessOffset(uint64 position, DataCache& cache, BufferView buffer, uint64 candidates)
+{
+    uint64 nextOffset = position + 1;
+    const auto count  = findings.size();
+
+    for (uint32 i = 0; i < static_cast<uint32>(Priority::Count); i++) {
+        const auto priority = static_cast<Priority>(i);
+        if (priority == Priority::Text) {
+            if (!IDrop::IsAsciiPrintable(buffer.GetData()[0])) {
+                continue;
+            }
+        }
+
+        for (uint32 j = 0; j < static_cast<uint32>(droppers.size()); j++) {
+            auto dropper = droppers[j];
+            if ((candidates & (1ULL << j)) == 0 || dropper->GetPriority() != priority) {
+                continue;
+            }
+
+            Finding finding{ .dropperName = dropper->GetName(), .category = dropper->GetCategory(), .subcategory = dropper->GetSubcategory() };
+            const auto result = dropper->Check(position, cache, buffer, finding);
+
+            if (result && finding.result != Result::NotFound) {
+                auto& f = findings.emplace_back(finding);
+
+                if (!recursive) {
+                    nextOffset = f.end;
+                }
+
+                // adjust for zones
+                if (f.result == Result::Unicode) {
+                    f.end -= 2;
+                } else if (f.result == Result::Ascii) {
+                    f.end -= 1;
+                } else {
+                    f.end += 1;
+                }
+
+                break;
+            }
+        }
+    }
+
+    if (findings.size() > count) {
+        steps.push_back({ position, nextOffset, count });
+    }
+
+    return nextOffset;
+}
+
+uint64 ObjectsSearch::Run(DataCache& cache, uint64 offset, uint64 end, const Progress& progress)
+{
+    uint64 toUpdate = offset / PROGRESS_STEP * PROGRESS_STEP;
+
+    // single pass over the data: the objects that start in the range can end after it and the search restarts from the
+    // end of an object when it is past the current chunk
+    const uint64 dataEnd = std::min<uint64>(cache.GetSize(), end + overlap);
+    bool stopped         = false;
+    while (offset < end && !stopped) {
+        bool restart = false;
+        auto range   = cache.Chunks(offset, dataEnd - offset, std::max<uint32>(cache.GetCacheSize(), overlap + 1), overlap);
+        for (const auto& chunk : range) {
+            const auto data   = chunk.data.GetData();
+            const auto length = static_cast<uint64>(chunk.data.GetLength());
+            if (offset >= chunk.offset + length) {
+                restart = true;
+                break;
+            }
+
+            // the last bytes of a chunk are processed with the next one
+            const auto limit = std::min<uint64>((chunk.offset + length >= dataEnd) ? length : length - overlap, end - chunk.offset);
+            auto i           = offset - chunk.offset;
+            if (!expressions.IsEmpty()) {
+                CHECK(expressions.Scan(chunk.data, chunk.offset, i, limit), offset, "");
+            }
+            if (!candidateRanges.IsEmpty()) {
+                CHECK(candidateRanges.Scan(chunk.data, chunk.offset, i, limit), offset, "");
+            }
+            while (i < limit) {
+                if (chunk.offset + i >= toUpdate) {
+                    if (!progress(chunk.offset + i)) {
+                        stopped = true;
+                        break;
+                    }
+                    toUpdate = ((chunk.offset + i) / PROGRESS_STEP + 1) * PROGRESS_STEP;
+                }
+                if (everyOffsetDroppers == 0) {
+                    const auto next      = std::min<uint64>(expressions.GetNextOffset(chunk.offset + i), candidateRanges.GetNextOffset(chunk.offset + i));
+                    const auto match     = next - chunk.offset;
+                    const auto searchEnd = std::min<uint64>({ limit, toUpdate - chunk.offset, match });
+                    i += signatures.Skip(data + i, static_cast<size_t>(searchEnd - i));
+                    if (i >= searchEnd && i != match) {
+                        continue;
+                    }
+                }
+
+                const auto position = chunk.offset + i;
+                const auto buffer   = length - i >= MAX_PRECACHED_BUFFER_SIZE ? BufferView(data + i, MAX_PRECACHED_BUFFER_SIZE)
+                                                                              : cache.Get(position, MAX_PRECACHED_BUFFER_SIZE, true);
+                if (buffer.GetLength() == 0) {
+                    stopped = true;
+                    break;
+                }
+
+                const auto candidates = everyOffsetDroppers | signatures.Match(buffer) | expressions.Match(position) | candidateRanges.Match(position);
+                i                     = candidates == 0 ? i + 1 : ProcessOffset(position, cache, buffer, candidates) - chunk.offset;
+            }
+            offset = chunk.offset + i;
+            if (stopped || offset >= end) {
+                break;
+            }
+        }
+        if (!restart) {
+            break;
+        }
+    }
+
+    return offset;
+}
+
+ParallelObjectsSearch::ParallelObjectsSearch(const std::vector<IDrop*>& _droppers, bool _recursive) : droppers(_droppers), recursive(_recursive)
+{
+}
+
+bool ParallelObjectsSearch::Run(
+      DataCache& cache,
+      const std::filesystem::path& path,
+      uint64 offset,
+      uint64 end,
+      uint32 threads,
+      uint32 shardsCount,
+      const Progress& progress,
+      const AddFindings& addFindings)
+{
+    CHECK(shardsCount > 0 && threads > 0 && offset < end, false, "");
+    const auto length = end - offset;
+
+    struct Shard {
+        uint64 start, end;
+        uint64 reached; // where the search of the worker stopped (past end if the last object ends after the shard)
+        ObjectsSearch search;
+        bool done;
+    };
+    std::vector<Shard> shards(shardsCount);
+    for (uint32 i = 0; i < shardsCount; i++) {
+        shards[i].start   = offset + length * i / shardsCount;
+        shards[i].end     = offset + length * (i + 1) / shardsCount;
+        shards[i].reached = shards[i].start;
+        shards[i].done    = false;
+    }
+
+    // the cache of the object is not thread safe: every worker reads the file through its own cache
+    const auto cacheSize = cache.GetCacheSize();
+    const auto mapped    = cache.IsMapped();
+    std::atomic<uint32> next{ 0 };
+    std::atomic<uint32> running{ 0 };
+    std::atomic<uint64> processed{ 0 };
+    std::atomic<uint32> found{ 0 };
+    std::atomic<bool> cancelled{ false };
+    std::mutex lock;
+    std::condition_variable finished;
+
+    const auto worker = [&]() {
+        DataCache data;
+        auto file = std::make_unique<AppCUI::OS::File>();
+        if (file->OpenRead(path) && data.Init(std::move(file), cacheSize)) {
+            if (mapped) {
+                data.MapFile(path);
+            }
+            DataCache::Tag tag(data, "Dropper");
+            for (auto index = next++; index < shardsCount && !cancelled; index = next++) {
+                auto& shard = shards[index];
+                if (!shard.search.Init(droppers, data, recursive)) {
+                    continue;
+                }
+                uint64 last       = shard.start;
+                size_t lastFound  = 0;
+                const auto Report = [&](uint64 position) {
+                    processed += position - last;
+                    found += static_cast<uint32>(shard.search.findings.size() - lastFound);
+                    last      = position;
+                    lastFound = shard.search.findings.size();
+                };
+                shard.reached = shard.search.Run(data, shard.start, shard.end, [&](uint64 position) -> bool {
+                    Report(position);
+                    return !cancelled;
+                });
+                Report(std::max<uint64>(std::min<uint64>(shard.reached, shard.end), last));
+                shard.done = shard.reached >= shard.end;
+            }
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        running--;
+        finished.notify_one();
+    };
+
+    const auto workers = std::min<uint32>(threads, shardsCount);
+    running            = workers;
+    std::vector<std::thread> pool;
+    pool.reserve(workers);
+    for (uint32 i = 0; i < workers; i++) {
+        pool.emplace_back(worker);
+    }
+
+    while (running > 0) {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            finished.wait_for(guard, std::chrono::milliseconds(100), [&]() { return running == 0; });
+        }
+        if (!cancelled && !progress(offset + processed, found)) {
+            cancelled = true;
+        }
+    }
+    for (auto& t : pool) {
+        t.join();
+    }
+
+    // the shards are merged in offset order: a serial search enters a shard where the previous object ended, not at its start,
+    // so the offsets it checks before it reaches one the worker also checked are searched again (the results of the two
+    // searches are the same from there on)
+    ObjectsSearch serial;
+    CHECK(serial.Init(droppers, cache, recursive), false, "");
+    const auto Continue = [&](uint64 from, uint64 to) -> uint64 {
+        const auto reached = serial.Run(cache, from, to, [&](uint64) -> bool { return !cancelled; });
+        addFindings(serial, 0);
+        serial.Clear();
+        return reached;
+    };
+
+    uint64 cursor = offset;
+    for (auto& shard : shards) {
+        if (cursor >= shard.end) {
+            continue;
+        }
+        if (!shard.done) {
+            // cancelled or the worker could not read the shard
+            CHECKBK(!cancelled, "");
+            cursor = Continue(cursor, shard.end);
+            CHECKBK(cursor >= shard.end, "");
+            continue;
+        }
+
+        const auto& steps = shard.search.steps;
+        const auto First  = [&steps](uint64 position) -> size_t {
+            return std::lower_bound(steps.begin(), steps.end(), position, [](const ObjectsSearch::Step& s, uint64 p) { return s.position < p; }) -
+                   steps.begin();
+        };
+        auto first = First(cursor);
+        // the worker skipped the cursor (it is inside an object the worker found)
+        while (cursor < shard.end && first > 0 && steps[first - 1].next > cursor) {
+            const auto limit = std::min<uint64>(steps[first - 1].next, shard.end);
+            cursor           = Continue(cursor, limit);
+            if (cursor < limit) {
+                return true;
+            }
+            first = First(cursor);
+        }
+        if (cursor >= shard.end) {
+            continue;
+        }
+        addFindings(shard.search, first);
+        cursor = shard.reached;
+    }
+
+    return true;
+}
+} // namespace GView::GenericPlugins::Droppper
@@ -0,0 +1,187 @@
+#include "Signatures.hpp"
+
+#include <algorithm>
+
+namespace GView::GenericPlugins::Droppper
+{
+SignatureIndex::SignatureIndex()
+{
+    memset(firstBytes, 0, sizeof(firstBytes));
+    maxLength = 0;
+}
+
+bool SignatureIndex::Add(std::string_view signature, uint32 dropper)
+{
+    CHECK(dropper < MAX_DROPPERS, false, "");
+    CHECK(signature.size() > 0 && signature.size() <= MAX_PRECACHED_BUFFER_SIZE, false, "");
+
+    const auto first = static_cast<uint8>(signature[0]);
+    entries[first].push_back({ signature, dropper });
+    firstBytes[first] = true;
+    maxLength         = std::max<uint32>(maxLength, static_cast<uint32>(signature.size()));
+
+    return true;
+}
+
+size_t SignatureIndex::Skip(const uint8* data, size_t size) const
+{
+    size_t i = 0;
+    // unrolled: most of the bytes of a large object are not the first byte of a signature
+    for (; i + 4 <= size; i += 4) {
+        if (firstBytes[data[i]] | firstBytes[data[i + 1]] | firstBytes[data[i + 2]] | firstBytes[data[i + 3]]) {
+            break;
+        }
+    }
+    while (i < size && !firstBytes[data[i]]) {
+        i++;
+    }
+    return i;
+}
+
+uint64 SignatureIndex::Match(BufferView data) const
+{
+    CHECK(data.GetLength() > 0, 0, "");
+
+    uint64 droppers = 0;
+    for (const auto& e : entries[data[0]]) {
+        if (e.signature.size() <= data.GetLength() && memcmp(data.GetData(), e.signature.data(), e.signature.size()) == 0) {
+            droppers |= 1ULL << e.dropper;
+        }
+    }
+    return droppers;
+}
+
+ExpressionIndex::ExpressionIndex()
+{
+    // the droppers compare case sensitive or not, the offsets found case insensitive are a superset for both of them
+    set.Init(false);
+    next = 0;
+}
+
+bool ExpressionIndex::Add(std::string_view expression, uint32 dropper)
+{
+    CHECK(dropper < SignatureIndex::MAX_DROPPERS, false, "");
+    CHECK(set.Add(expression) == static_cast<int32>(droppers.size()), false, "");
+    droppers.push_back(dropper);
+
+    return true;
+}
+
+bool ExpressionIndex::Compile()
+{
+    return set.Compile();
+}
+
+bool ExpressionIndex::Scan(BufferView data, uint64 dataOffset, uint64 from, uint64 to)
+{
+    hits.clear();
+    next = 0;
+    CHECK(to <= data.GetLength(), false, "");
+    if (from >= to) {
+        return true;
+    }
+
+    const BufferView text(data.GetData() + from, data.GetLength() - from);
+    matched.clear();
+    if (!set.Match(text, matched)) {
+        // the combined automaton gave up, every expression is searched
+        matched.clear();
+        for (uint32 i = 0; i < static_cast<uint32>(droppers.size()); i++) {
+            matched.push_back(i);
+        }
+    }
+
+    // every offset where an expression matches (the matches of an expression can overlap)
+    const auto size = to - from;
+    for (const auto expression : matched) {
+        uint64 start, end;
+        for (uint64 i = 0; i < size && set.Find(expression, text, i, start, end) && start < size; i = start + 1) {
+            hits.push_back({ dataOffset + from + start, 1ULL << droppers[expression] });
+        }
+    }
+    if (matched.size() > 1) {
+        std::sort(hits.begin(), hits.end(), [](const Hit& a, const Hit& b) { return a.offset < b.offset; });
+        size_t count = 0;
+        for (const auto& h : hits) {
+            if (count > 0 && hits[count - 1].offset == h.offset) {
+                hits[count - 1].droppers |= h.droppers;
+            } else {
+                hits[count++] = h;
+            }
+        }
+        hits.resize(count);
+    }
+
+    return true;
+}
+
+uint64 ExpressionIndex::GetNextOffset(uint64 offset)
+{
+    while (next < hits.size() && hits[next].offset < offset) {
+        next++;
+    }
+    return next < hits.size() ? hits[next].offset : UINT64_MAX;
+}
+
+uint64 ExpressionIndex::Match(uint64 offset)
+{
+    return GetNextOffset(offset) == offset ? hits[next].droppers : 0;
+}
+
+CandidateIndex::CandidateIndex()
+{
+    window = 0;
+}
+
+bool CandidateIndex::Add(IDrop* dropper, uint32 index)
+{
+    CHECK(index < SignatureIndex::MAX_DROPPERS, false, "");
+    CHECK(dropper->GetCandidatesWindow() > 0, false, "");
+    sources.push_back({ dropper, index, {}, 0 });
+    window = std::max<uint32>(window, dropper->GetCandidatesWindow());
+
+    return true;
+}
+
+bool CandidateIndex::Scan(BufferView data, uint64 dataOffset, uint64 from, uint64 to)
+{
+    CHECK(to <= data.GetLength(), false, "");
+    for (auto& s : sources) {
+        s.ranges.clear();
+        s.next = 0;
+        if (from < to) {
+            s.dropper->GetCandidates(data, dataOffset, from, to, s.ranges);
+        }
+    }
+
+    return true;
+}
+
+uint64 CandidateIndex::GetNextOffset(uint64 offset)
+{
+    uint64 result = UINT64_MAX;
+    for (auto& s : sources) {
+        while (s.next < s.ranges.size() && s.ranges[s.next].end <= offset) {
+            s.next++;
+        }
+        if (s.next < s.ranges.size()) {
+            result = std::min<uint64>(result, std::max<uint64>(s.ranges[s.next].start, offset));
+        }
+    }
+    return result;
+}
+
+uint64 CandidateIndex::Match(uint64 offset)
+{
+    uint64 mask = 0;
+    for (auto& s : sources) {
+        while (s.next < s.ranges.size() && s.ranges[s.next].end <= offset) {
+            s.next++;
+        }
+        if (s.next < s.ranges.size() && s.ranges[s.next].start <= offset) {
+            mask |= 1ULL << s.index;
+        }
+    }
+    return mask;
+}
+} // namespace GView::GenericPlugins::Droppper
@@ -4,15 +4,14 @@
 
 namespace GView::GenericPlugins::Droppper::SpecialStrings
 {
-static constexpr std::string_view EMAIL_REGEX_ASCII{ R"(^([a-z0-9\_\.]+@[a-z\_]+\.[a-z]{2,5}))" };
-static constexpr std::string_view EMAIL_REGEX_UNICODE{ R"(^(([a-z0-9\_\.]\x00)+@\x00([a-z\_]\x00)+\.\x00([a-z]\x00){2,5}))" };
+static constexpr std::string_view EMAIL_REGEX_ASCII{ R"(([a-z0-9\_\.]+@[a-z\_]+\.[a-z]{2,5}))" };
+static constexpr std::string_view EMAIL_REGEX_UNICODE{ R"((([a-z0-9\_\.]\x00)+@\x00([a-z\_]\x00)+\.\x00([a-z]\x00){2,5}))" };
 
 EmailAddress::EmailAddress(bool caseSensitive, bool unicode)
 {
     this->unicode       = unicode;
     this->caseSensitive = caseSensitive;
-    this->matcherAscii.Init(EMAIL_REGEX_ASCII, unicode, caseSensitive);
-    this->matcherUnicode.Init(EMAIL_REGEX_UNICODE, unicode, caseSensitive);
+    SetExpressions(EMAIL_REGEX_ASCII, EMAIL_REGEX_UNICODE);
 }
 
 const std::string_view EmailAddress::GetName() const
@@ -35,7 +34,7 @@ bool EmailAddress::Check(uint64 offset, DataCache& file, BufferView precachedBuf
     CHECK(precachedBuffer.GetLength() > 0, false, "");
     CHECK(IsAsciiPrintable(precachedBuffer.GetData()[0]), false, "");
 
-    auto buffer = file.Get(offset, file.GetCacheSize() / 12, false);
+    auto buffer = file.Get(offset, GetExpressionsWindow(file), false);
     CHECK(buffer.GetLength() >= 4, false, "");
 
     if (this->matcherAscii.Match(buffer, finding.start, finding.end)) {
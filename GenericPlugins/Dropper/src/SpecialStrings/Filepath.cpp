@@ -4,17 +4,16 @@
 
 namespace GView::GenericPlugins::Droppper::SpecialStrings
 {
-static constexpr std::string_view PATH_REGEX_ASCII{ R"(^(([a-zA-Z]{1}\:\\[a-zA-Z0-9\\_\. ]+)|(((\/|\.\.)[a-zA-Z\/\.0-9]+\/[a-zA-Z\/\.0-9]+))))" };
+static constexpr std::string_view PATH_REGEX_ASCII{ R"((([a-zA-Z]{1}\:\\[a-zA-Z0-9\\_\. ]+)|(((\/|\.\.)[a-zA-Z\/\.0-9]+\/[a-zA-Z\/\.0-9]+))))" };
 static constexpr std::string_view PATH_REGEX_UNICODE{
-    R"(^((([a-zA-Z]\x00){1}\\x00:\x00\\x00\\x00([a-zA-Z0-9\\_\. ]\x00)+)|((((\/\x00)|\.\x00\.\x00)([a-zA-Z\/\.0-9]\x00)+\/\x00([a-zA-Z\/\.0-9]\x00)+))))"
+    R"(((([a-zA-Z]\x00){1}\\x00:\x00\\x00\\x00([a-zA-Z0-9\\_\. ]\x00)+)|((((\/\x00)|\.\x00\.\x00)([a-zA-Z\/\.0-9]\x00)+\/\x00([a-zA-Z\/\.0-9]\x00)+))))"
 };
 
 Filepath::Filepath(bool caseSensitive, bool unicode)
 {
     this->unicode       = unicode;
     this->caseSensitive = caseSensitive;
-    this->matcherAscii.Init(PATH_REGEX_ASCII, unicode, caseSensitive);
-    this->matcherUnicode.Init(PATH_REGEX_UNICODE, unicode, caseSensitive);
+    SetExpressions(PATH_REGEX_ASCII, PATH_REGEX_UNICODE);
 }
 
 const std::string_view Filepath::GetName() const
@@ -37,7 +36,7 @@ bool Filepath::Check(uint64 offset, DataCache& file, BufferView precachedBuffer,
     CHECK(precachedBuffer.GetLength() > 0, false, "");
     CHECK(IsAsciiPrintable(precachedBuffer.GetData()[0]), false, "");
 
-    auto buffer = file.Get(offset, file.GetCacheSize() / 12, false);
+    auto buffer = file.Get(offset, GetExpressionsWindow(file), false);
     CHECK(buffer.GetLength() >= 4, false, "");
 
     if (this->matcherAscii.Match(buffer, finding.start, finding.end)) {
@@ -4,17 +4,16 @@
 
 namespace GView::GenericPlugins::Droppper::SpecialStrings
 {
-static const std::string_view IPS_REGEX_ASCII{ R"(^([0-9]{1,3}\.[0-9]{1,3}\.[0-9]{1,3}\.[0-9]{1,3}(\:[0-9]{1,5})*))" };
+static const std::string_view IPS_REGEX_ASCII{ R"(([0-9]{1,3}\.[0-9]{1,3}\.[0-9]{1,3}\.[0-9]{1,3}(\:[0-9]{1,5})*))" };
 static const std::string_view IPS_REGEX_UNICODE{
-    R"(^(([0-9]\x00){1,3}\.\x00([0-9]\x00){1,3}\.\x00([0-9]\x00){1,3}\.\x00([0-9]\x00){1,3}(\:\x00([0-9]\x00){1,5})*))"
+    R"((([0-9]\x00){1,3}\.\x00([0-9]\x00){1,3}\.\x00([0-9]\x00){1,3}\.\x00([0-9]\x00){1,3}(\:\x00([0-9]\x00){1,5})*))"
 };
 
 IpAddress::IpAddress(bool caseSensitive, bool unicode)
 {
     this->unicode       = unicode;
     this->caseSensitive = caseSensitive;
-    this->matcherAscii.Init(IPS_REGEX_ASCII, unicode, caseSensitive);
-    this->matcherUnicode.Init(IPS_REGEX_UNICODE, unicode, caseSensitive);
+    SetExpressions(IPS_REGEX_ASCII, IPS_REGEX_UNICODE);
 }
 
 const std::string_view IpAddress::GetName() const
@@ -32,12 +31,17 @@ Subcategory IpAddress::GetSubcategory() const
     return Subcategory::IP;
 }
 
+uint32 IpAddress::GetExpressionsWindow(DataCache& file) const
+{
+    return 39 * 2; // IPv6 length in Unicode
+}
+
 bool IpAddress::Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding)
 {
     CHECK(precachedBuffer.GetLength() > 0, false, "");
     CHECK(IsAsciiPrintable(precachedBuffer.GetData()[0]), false, "");
 
-    auto buffer = file.Get(offset, 39 * 2, false); // IPv6 length in Unicode
+    auto buffer = file.Get(offset, GetExpressionsWindow(file), false);
     CHECK(buffer.GetLength() >= 14, false, "");    // not enough for IPv4 => length in ASCII
 
     if (this->matcherAscii.Match(buffer, finding.start, finding.end)) {
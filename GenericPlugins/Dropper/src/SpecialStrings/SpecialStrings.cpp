@@ -18,4 +18,31 @@ bool SpecialStrings::ShouldGroupInOneFile() const
 {
     return true;
 }
+
+bool SpecialStrings::SetExpressions(std::string_view ascii, std::string_view unicode)
+{
+    this->expressionAscii   = ascii;
+    this->expressionUnicode = unicode;
+
+    CHECK(this->matcherAscii.Init(std::string("^").append(ascii), this->unicode, this->caseSensitive), false, "");
+    CHECK(this->matcherUnicode.Init(std::string("^").append(unicode), this->unicode, this->caseSensitive), false, "");
+
+    return true;
+}
+
+std::vector<std::string_view> SpecialStrings::GetExpressions() const
+{
+    if (this->expressionAscii.empty()) {
+        return {};
+    }
+    if (this->unicode) {
+        return { this->expressionAscii, this->expressionUnicode };
+    }
+    return { this->expressionAscii };
+}
+
+uint32 SpecialStrings::GetExpressionsWindow(DataCache& file) const
+{
+    return file.GetCacheSize() / 12;
+}
 } // namespace GView::GenericPlugins::Droppper::SpecialStrings
@@ -1,13 +1,170 @@
 #include "SpecialStrings.hpp"
 
 #include <string>
+#include <bit>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#    define TEXT_CLASSIFY_X64
+#    include <immintrin.h>
+#    ifdef _MSC_VER
+#        include <intrin.h>
+#        define TARGET_AVX2
+#    else
+#        define TARGET_AVX2 __attribute__((target("avx2")))
+#    endif
+#endif
 
 namespace GView::GenericPlugins::Droppper::SpecialStrings
 {
+// ======================================================[Scalar]======================================================
+static void ClassifyScalar(const Text::CharSet& charSet, const uint8* data, uint64& valid, uint64& zero)
+{
+    valid = 0;
+    zero  = 0;
+    for (uint32 i = 0; i < Text::BLOCK_SIZE; i++) {
+        valid |= static_cast<uint64>(charSet.matrix[data[i]]) << i;
+        zero |= static_cast<uint64>(data[i] == 0) << i;
+    }
+}
+
+#ifdef TEXT_CLASSIFY_X64
+// ======================================================[SSE2]========================================================
+// x is in [first, last] when x - first <= last - first (unsigned): moved by 0x80 so that a single signed compare checks it
+static void ClassifySSE2(const Text::CharSet& charSet, const uint8* data, uint64& valid, uint64& zero)
+{
+    valid = 0;
+    zero  = 0;
+    for (uint32 i = 0; i < Text::BLOCK_SIZE; i += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i outside = _mm_set1_epi8(-1);
+        for (uint32 r = 0; r < charSet.rangesCount; r++) {
+            const auto first   = charSet.ranges[r][0];
+            const auto last    = charSet.ranges[r][1];
+            const auto shifted = _mm_add_epi8(x, _mm_set1_epi8(static_cast<char>(0x80 - first)));
+            outside            = _mm_and_si128(outside, _mm_cmpgt_epi8(shifted, _mm_set1_epi8(static_cast<char>(last - first - 0x80))));
+        }
+        valid |= static_cast<uint64>(static_cast<uint16>(~_mm_movemask_epi8(outside))) << i;
+        zero |= static_cast<uint64>(static_cast<uint16>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_setzero_si128())))) << i;
+    }
+}
+
+// ======================================================[AVX2]========================================================
+// any charset: the low nibble selects a row of bits (one for each high nibble) and the high nibble the bit from the row
+TARGET_AVX2 static void ClassifyAVX2(const Text::CharSet& charSet, const uint8* data, uint64& valid, uint64& zero)
+{
+    const __m256i rowsLow  = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(charSet.nibbles[0])));
+    const __m256i rowsHigh = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(charSet.nibbles[1])));
+    const __m256i bits     = _mm256_broadcastsi128_si256(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+    const __m256i nibble   = _mm256_set1_epi8(0x0F);
+
+    valid = 0;
+    zero  = 0;
+    for (uint32 i = 0; i < Text::BLOCK_SIZE; i += 32) {
+        const __m256i x    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i low  = _mm256_and_si256(x, nibble);
+        const __m256i high = _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble);
+        // the sign bit of x (high nibble >= 8) selects the rows of the second table
+        const __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(rowsLow, low), _mm256_shuffle_epi8(rowsHigh, low), x);
+        const __m256i bit = _mm256_shuffle_epi8(bits, high);
+        valid |= static_cast<uint64>(static_cast<uint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit)))) << i;
+        zero |= static_cast<uint64>(static_cast<uint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_setzero_si256())))) << i;
+    }
+}
+
+static bool IsAVX2Supported()
+{
+#    ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx     = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#    else
+    return __builtin_cpu_supports("avx2");
+#    endif
+}
+#endif
+
+// ======================================================[Runs]========================================================
+// bits 0, 2, 4, ... of value moved to bits 0, 1, 2, ...
+static uint32 EvenBits(uint64 value)
+{
+    value &= 0x5555555555555555ULL;
+    value = (value | (value >> 1)) & 0x3333333333333333ULL;
+    value = (value | (value >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+    value = (value | (value >> 4)) & 0x00FF00FF00FF00FFULL;
+    value = (value | (value >> 8)) & 0x0000FFFF0000FFFFULL;
+    value = (value | (value >> 16)) & 0x00000000FFFFFFFFULL;
+    return static_cast<uint32>(value);
+}
+
+// the runs of valid characters (one every `stride` bytes): a run of count characters that starts at `start` gives strings of
+// more than `minimum` characters at the offsets start, start + stride, ... start + (count - minimum - 1) * stride
+class RunTracker
+{
+    std::vector<OffsetRange>& ranges;
+    uint64 minimum;
+    uint32 stride;
+    uint64 start;
+    uint64 count;
+    bool inRun;
+
+  public:
+    RunTracker(std::vector<OffsetRange>& ranges, uint64 minimum, uint32 stride) : ranges(ranges), minimum(minimum), stride(stride)
+    {
+        start = 0;
+        count = 0;
+        inRun = false;
+    }
+
+    // bit j of bits (less than n) is the character at base + j * stride
+    void Add(uint64 bits, uint32 n, uint64 base)
+    {
+        uint32 j = 0;
+        while (j < n) {
+            if (!inRun) {
+                const auto skip = static_cast<uint32>(std::countr_zero(bits >> j));
+                if (skip >= n - j) {
+                    break;
+                }
+                j += skip;
+                start = base + static_cast<uint64>(j) * stride;
+                count = 0;
+                inRun = true;
+            }
+            const auto length = static_cast<uint32>(std::countr_one(bits >> j));
+            count += length;
+            j += length;
+            if (j < n) {
+                End();
+            }
+        }
+    }
+
+    void End()
+    {
+        if (inRun && count > minimum) {
+            ranges.push_back({ start, start + (count - minimum - 1) * stride + 1 });
+        }
+        inRun = false;
+    }
+};
+
+// ======================================================[Text]========================================================
 Text::Text(bool caseSensitive, bool unicode)
 {
     this->unicode       = unicode;
     this->caseSensitive = caseSensitive;
+    this->classify      = ClassifyScalar;
 }
 
 const std::string_view Text::GetName() const
@@ -25,6 +182,95 @@ Subcategory Text::GetSubcategory() const
     return Subcategory::Text;
 }
 
+void Text::Classify(const uint8* data, uint64 size, uint64& valid, uint64& zero) const
+{
+    if (size >= BLOCK_SIZE) {
+        classify(charSet, data, valid, zero);
+        return;
+    }
+
+    uint8 block[BLOCK_SIZE]{};
+    memcpy(block, data, size);
+    classify(charSet, block, valid, zero);
+    valid &= (1ULL << size) - 1;
+    zero &= (1ULL << size) - 1;
+}
+
+// number of characters of the charset (at most limit) data starts with, an UTF-16 character is a byte of the charset and 0
+uint64 Text::CountValid(const uint8* data, uint64 size, bool isUnicode, uint64 limit) const
+{
+    uint64 count = 0;
+    for (uint64 i = 0; i < size && count < limit; i += BLOCK_SIZE) {
+        const auto n = static_cast<uint32>(std::min<uint64>(BLOCK_SIZE, size - i));
+        uint64 valid, zero;
+        Classify(data + i, n, valid, zero);
+
+        if (isUnicode) {
+            const uint64 next  = (i + n < size && data[i + n] == 0) ? 1 : 0;
+            const uint64 chars = valid & ((zero >> 1) | (next << (n - 1)));
+            const auto run     = static_cast<uint32>(std::countr_one(EvenBits(chars)));
+            count += run;
+            CHECKBK(run == n / 2, "");
+        } else {
+            const auto run = static_cast<uint32>(std::countr_one(valid));
+            count += run;
+            CHECKBK(run == n, "");
+        }
+    }
+
+    return std::min<uint64>(count, limit);
+}
+
+uint32 Text::GetCandidatesWindow() const
+{
+    // the bytes of minLength + 1 UTF-16 characters decide an offset
+    return 2 * (this->minLength + 1);
+}
+
+void Text::GetCandidates(BufferView data, uint64 dataOffset, uint64 from, uint64 to, std::vector<OffsetRange>& ranges) const
+{
+    const auto end         = std::min<uint64>(data.GetLength(), to + GetCandidatesWindow());
+    const auto findUnicode = this->unicode && (this->maxLength + 1) / 2 > this->minLength;
+
+    // a single pass over the data: the runs of ASCII characters and the runs of UTF-16 characters that start at even and at
+    // odd offsets
+    RunTracker ascii(ranges, this->minLength, 1);
+    RunTracker wide[2]{ { ranges, this->minLength, 2 }, { ranges, this->minLength, 2 } };
+    for (uint64 i = from; i < end; i += BLOCK_SIZE) {
+        const auto n = static_cast<uint32>(std::min<uint64>(BLOCK_SIZE, end - i));
+        uint64 valid, zero;
+        Classify(data.GetData() + i, n, valid, zero);
+
+        ascii.Add(valid, n, dataOffset + i);
+        if (findUnicode) {
+            const uint64 next  = (i + n < end && data.GetData()[i + n] == 0) ? 1 : 0;
+            const uint64 chars = valid & ((zero >> 1) | (next << (n - 1)));
+            wide[0].Add(EvenBits(chars), (n + 1) / 2, dataOffset + i);
+            wide[1].Add(EvenBits(chars >> 1), n / 2, dataOffset + i + 1);
+        }
+    }
+    ascii.End();
+    wide[0].End();
+    wide[1].End();
+
+    // the ranges of the three runs overlap: they are merged and limited to [from, to)
+    std::sort(ranges.begin(), ranges.end(), [](const OffsetRange& a, const OffsetRange& b) { return a.start < b.start; });
+    size_t count = 0;
+    for (const auto& r : ranges) {
+        const auto start = std::max<uint64>(r.start, dataOffset + from);
+        const auto stop  = std::min<uint64>(r.end, dataOffset + to);
+        if (start >= stop) {
+            continue;
+        }
+        if (count > 0 && start <= ranges[count - 1].end) {
+            ranges[count - 1].end = std::max<uint64>(ranges[count - 1].end, stop);
+        } else {
+            ranges[count++] = { start, stop };
+        }
+    }
+    ranges.resize(count);
+}
+
 bool Text::Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding)
 {
     CHECK(precachedBuffer.GetLength() > 0, false, "");
@@ -35,49 +281,29 @@ bool Text::Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Fin
     if (isUnicode) {
         CHECK(unicode, false, "");
     }
+    const uint32 width = isUnicode ? 2 : 1;
 
     auto buffer = file.Get(offset, file.GetCacheSize() / 12, false);
-    CHECK(buffer.GetLength() >= this->minLength * (isUnicode ? 2 : 1), false, "");
-
-    finding.start = offset;
-    finding.end   = offset;
-
-    uint64 i = 0;
-    while (finding.end - finding.start < this->maxLength) {
-        const auto c = buffer.GetData()[i];
-        CHECKBK(IsValidChar(c), "");
-
-        if (isUnicode && unicode) {
-            CHECKBK(buffer.GetData()[i + 1] == 0, "");
-            finding.end += 1;
-            i++;
-        }
+    CHECK(buffer.GetLength() >= this->minLength * width, false, "");
 
-        finding.end += 1;
-        i++;
+    // maxLength is in bytes, an UTF-16 character is not split
+    const uint64 limit = (this->maxLength + width - 1) / width;
+    uint64 count       = 0;
+    while (count < limit) {
+        const auto run = CountValid(buffer.GetData(), buffer.GetLength(), isUnicode, limit - count);
+        count += run;
+        CHECKBK(run == buffer.GetLength() / width, "");
 
-        if (i + 1 >= buffer.GetLength()) {
-            offset += i + 1;
-            buffer = file.Get(offset, file.GetCacheSize() / 12, false);
-            if (buffer.GetLength() == 0) {
-                break;
-            }
-            i = 0;
-        }
+        buffer = file.Get(offset + count * width, file.GetCacheSize() / 12, false);
+        CHECKBK(buffer.GetLength() >= width, "");
     }
 
+    finding.start = offset;
+    finding.end   = offset + count * width;
     CHECK(finding.start < finding.end, false, "");
 
-    if (isUnicode && unicode) {
-        if ((finding.end - finding.start) / 2 > this->minLength) {
-            finding.result = Result::Unicode;
-            return true;
-        }
-    } else {
-        if ((finding.end - finding.start) > this->minLength) {
-            finding.result = Result::Ascii;
-            return true;
-        }
+    if (count > this->minLength) {
+        finding.result = isUnicode ? Result::Unicode : Result::Ascii;
     }
 
     return true;
@@ -116,11 +342,41 @@ bool Text::SetUnicode(bool value)
 
 void Text::SetMatrix(bool matrix[STRINGS_CHARSET_MATRIX_SIZE])
 {
-    memcpy(this->stringsCharSetMatrix, matrix, STRINGS_CHARSET_MATRIX_SIZE);
+    memcpy(this->charSet.matrix, matrix, STRINGS_CHARSET_MATRIX_SIZE);
+
+    memset(this->charSet.nibbles, 0, sizeof(this->charSet.nibbles));
+    uint32 ranges = 0;
+    for (uint32 c = 0; c < STRINGS_CHARSET_MATRIX_SIZE; c++) {
+        if (!matrix[c]) {
+            continue;
+        }
+        this->charSet.nibbles[c >> 7][c & 0x0F] |= static_cast<uint8>(1 << ((c >> 4) & 7));
+        if (c > 0 && matrix[c - 1]) {
+            if (ranges <= CharSet::MAX_RANGES) {
+                this->charSet.ranges[ranges - 1][1] = static_cast<uint8>(c);
+            }
+            continue;
+        }
+        if (++ranges <= CharSet::MAX_RANGES) {
+            this->charSet.ranges[ranges - 1][0] = static_cast<uint8>(c);
+            this->charSet.ranges[ranges - 1][1] = static_cast<uint8>(c);
+        }
+    }
+    this->charSet.rangesCount = ranges <= CharSet::MAX_RANGES ? ranges : 0;
+
+    this->classify = ClassifyScalar;
+#ifdef TEXT_CLASSIFY_X64
+    static const bool hasAVX2 = IsAVX2Supported();
+    if (hasAVX2) {
+        this->classify = ClassifyAVX2;
+    } else if (this->charSet.rangesCount > 0) {
+        this->classify = ClassifySSE2;
+    }
+#endif
 }
 
 bool Text::IsValidChar(char c) const
 {
-    return this->stringsCharSetMatrix[c];
+    return this->charSet.matrix[static_cast<uint8>(c)];
 }
 } // namespace GView::GenericPlugins::Droppper::SpecialStrings
@@ -4,17 +4,16 @@
 
 namespace GView::GenericPlugins::Droppper::SpecialStrings
 {
-static const std::string_view URL_REGEX_ASCII{ R"(^(((https*:\/\/)|((https*:\/\/www)|(www)\.))[a-zA-Z0-9_]+\.[a-zA-Z0-9_\.]+(\/[a-zA-Z0-9_\.]*)*))" };
+static const std::string_view URL_REGEX_ASCII{ R"((((https*:\/\/)|((https*:\/\/www)|(www)\.))[a-zA-Z0-9_]+\.[a-zA-Z0-9_\.]+(\/[a-zA-Z0-9_\.]*)*))" };
 static const std::string_view URL_REGEX_UNICODE{
-    R"(^(((h\x00t\x00t\x00p\x00(s\x00)*:\x00\/\x00\/\x00)|((h\x00t\x00t\x00p\x00(s\x00)*:\x00\/\x00\/\x00w\x00w\x00w\x00)|(w\x00w\x00w\x00)\.\x00))([a-zA-Z0-9_]\x00)+\.\x00([a-zA-Z0-9_\.]\x00)+(\/\x00([a-zA-Z0-9_\.]\x00)*)*))"
+    R"((((h\x00t\x00t\x00p\x00(s\x00)*:\x00\/\x00\/\x00)|((h\x00t\x00t\x00p\x00(s\x00)*:\x00\/\x00\/\x00w\x00w\x00w\x00)|(w\x00w\x00w\x00)\.\x00))([a-zA-Z0-9_]\x00)+\.\x00([a-zA-Z0-9_\.]\x00)+(\/\x00([a-zA-Z0-9_\.]\x00)*)*))"
 };
 
 URL::URL(bool caseSensitive, bool unicode)
 {
     this->unicode       = unicode;
     this->caseSensitive = caseSensitive;
-    this->matcherAscii.Init(URL_REGEX_ASCII, unicode, caseSensitive);
-    this->matcherUnicode.Init(URL_REGEX_UNICODE, unicode, caseSensitive);
+    SetExpressions(URL_REGEX_ASCII, URL_REGEX_UNICODE);
 }
 
 const std::string_view URL::GetName() const
@@ -37,7 +36,7 @@ bool URL::Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Find
     CHECK(precachedBuffer.GetLength() > 0, false, "");
     CHECK(IsAsciiPrintable(precachedBuffer.GetData()[0]), false, "");
 
-    auto buffer = file.Get(offset, file.GetCacheSize() / 12, false);
+    auto buffer = file.Get(offset, GetExpressionsWindow(file), false);
     CHECK(buffer.GetLength() >= 4, false, "");
 
     if (this->matcherAscii.Match(buffer, finding.start, finding.end)) {
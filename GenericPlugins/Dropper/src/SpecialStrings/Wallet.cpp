@@ -13,6 +13,11 @@ constexpr std::string_view Ethereum_MAGIC{ "0x" };
 constexpr std::string_view Stellar_MEMO_MAGIC{ "G" };
 constexpr std::string_view Stellar_MUXED_MAGIC{ "M" };
 
+// the same prefixes in UTF-16 (the one letter prefixes are already found by their ASCII form)
+constexpr std::string_view Bitcoin_P2WPKH_MAGIC_UNICODE{ "b\0c\0" "1\0q\0", 8 };
+constexpr std::string_view Bitcoin_P2TR_MAGIC_UNICODE{ "b\0c\0" "1\0p\0", 8 };
+constexpr std::string_view Ethereum_MAGIC_UNICODE{ "0\0x\0", 4 };
+
 static std::map<WalletType, uint32> WALLET_ADDRESS_LENGTH{
     { WalletType::Bitcoin_P2WPKH, 42 }, { WalletType::Bitcoin_P2WSH, 62 }, { WalletType::Bitcoin_P2TR, 62 },
     { WalletType::Ethereum, 42 },       { WalletType::Stellar_MEMO, 56 },  { WalletType::Stellar_MUXED, 69 },
@@ -45,6 +50,15 @@ Subcategory Wallet::GetSubcategory() const
     return Subcategory::Wallet;
 }
 
+std::vector<std::string_view> Wallet::GetSignatures() const
+{
+    if (unicode) {
+        return { Bitcoin_P2WPKH_MAGIC,         Bitcoin_P2TR_MAGIC,         Ethereum_MAGIC,        Stellar_MEMO_MAGIC, Stellar_MUXED_MAGIC,
+                 Bitcoin_P2WPKH_MAGIC_UNICODE, Bitcoin_P2TR_MAGIC_UNICODE, Ethereum_MAGIC_UNICODE };
+    }
+    return { Bitcoin_P2WPKH_MAGIC, Bitcoin_P2TR_MAGIC, Ethereum_MAGIC, Stellar_MEMO_MAGIC, Stellar_MUXED_MAGIC };
+}
+
 bool Wallet::Check(uint64 offset, DataCache& file, BufferView precachedBuffer, Finding& finding)
 {
     CHECK(precachedBuffer.GetLength() > 0, false, "");
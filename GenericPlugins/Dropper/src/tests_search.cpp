@@ -0,0 +1,74 @@
+#include <catch.hpp>
+#include "Search.hpp"
+#include "SpecialStrings.hpp"
+
+#include <fstream>
+#include <random>
+
+using namespace GView::GenericPlugins::Droppper;
+
+// the URLs are longer than the window the droppers read (the cache size / 12): they are cut at the end of the window and the
+// search continues from there, so the searches on several threads find the same objects only if their caches have the same size
+constexpr uint32 TEST_CACHE_SIZE = 0x10000;
+constexpr uint64 TEST_FILE_SIZE  = 0x180000;
+constexpr uint32 TEST_SHARDS     = 16;
+
+static std::vector<Finding> SearchInParallel(DataCache& cache, const std::filesystem::path& path, const std::vector<IDrop*>& droppers)
+{
+    std::vector<Finding> result;
+    ParallelObjectsSearch search(droppers, false);
+    const auto Add = [&](const ObjectsSearch& found, size_t firstStep) {
+        if (firstStep < found.steps.size()) {
+            result.insert(result.end(), found.findings.begin() + found.steps[firstStep].firstFinding, found.findings.end());
+        }
+    };
+    REQUIRE(search.Run(cache, path, 0, TEST_FILE_SIZE, 4, TEST_SHARDS, [](uint64, uint32) { return true; }, Add));
+    return result;
+}
+
+TEST_CASE("DropperParallelSearch", "[Dropper]")
+{
+    const auto path = std::filesystem::temp_directory_path() / "gview_dropper_search.bin";
+    std::vector<uint8> content(TEST_FILE_SIZE);
+    std::mt19937_64 generator(TEST_FILE_SIZE);
+    for (auto& b : content) {
+        b = static_cast<uint8>(generator() % 0x20); // no printable characters outside the URLs
+    }
+    uint32 longest = 0;
+    for (uint64 position = 0x1000; position + 0x6000 < TEST_FILE_SIZE; position += 0x6000 + generator() % 0x4000) {
+        const auto url = "http://www." + std::string(100 + generator() % 0x5000, 'a') + ".com/index.html";
+        memcpy(content.data() + position, url.data(), url.size());
+        longest = std::max<uint32>(longest, static_cast<uint32>(url.size()));
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(content.data()), content.size());
+        REQUIRE((bool) out);
+    }
+
+    SpecialStrings::URL url(false, false);
+    const std::vector<IDrop*> droppers{ &url };
+
+    DataCache cache;
+    auto file = std::make_unique<AppCUI::OS::File>();
+    REQUIRE(file->OpenRead(path));
+    REQUIRE(cache.Init(std::move(file), TEST_CACHE_SIZE));
+    REQUIRE(url.GetExpressionsWindow(cache) < longest);
+
+    ObjectsSearch serial;
+    REQUIRE(serial.Init(droppers, cache, false));
+    REQUIRE(serial.Run(cache, 0, TEST_FILE_SIZE, [](uint64) { return true; }) >= TEST_FILE_SIZE);
+    REQUIRE(serial.findings.size() > TEST_SHARDS);
+
+    const auto parallel = SearchInParallel(cache, path, droppers);
+    REQUIRE(parallel.size() == serial.findings.size());
+    for (size_t i = 0; i < parallel.size(); i++) {
+        INFO(i);
+        REQUIRE(parallel[i].start == serial.findings[i].start);
+        REQUIRE(parallel[i].end == serial.findings[i].end);
+        REQUIRE(parallel[i].result == serial.findings[i].result);
+    }
+
+    std::error_code error;
+    std::filesystem::remove(path, error);
+}
@@ -150,6 +150,8 @@ bool Plugin::DrawEntropy(EntropyType type)
     canvas->Resize(maxX, maxY, 'X', color);
     canvas->ClearEntireSurface('X', color);
 
+    // every block is read once, from the start of the file to the end
+    GView::Utils::DataCache::HintGuard hint(cache, GView::Utils::DataCache::AccessPattern::Sequential);
     for (uint32 i = 0; i < blocksCount; i++) {
         auto bf    = cache.Get(i * static_cast<uint64>(this->blockSize), this->blockSize, false);
         auto value = 0.0;
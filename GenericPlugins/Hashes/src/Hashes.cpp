@@ -683,7 +683,7 @@ static bool ComputeHash(
         }
     }
 
-    const auto UpdateHashOnBuffer = [&](const Buffer& buffer)
+    const auto UpdateHashOnBuffer = [&](const BufferView& buffer)
     {
         for (const auto& hash : hashList)
         {
@@ -775,20 +775,13 @@ static bool ComputeHash(
 
     const auto UpdateHashOnBlock = [&](uint64 offset, uint64 left)
     {
-        do
+        auto chunks = object->GetData().Chunks(offset, left, block);
+        for (const auto& chunk : chunks)
         {
-            CHECK(ProgressStatus::Update(offset, ls.Format(format, offset, objectSize)) == false, false, "");
-
-            const auto sizeToRead = (left >= block ? block : left);
-            left -= (left >= block ? block : left);
-
-            const Buffer buffer = object->GetData().CopyToBuffer(offset, static_cast<uint32>(sizeToRead), true);
-            CHECK(buffer.IsValid(), false, "");
-
-            CHECK(UpdateHashOnBuffer(buffer), false, "");
-
-            offset += sizeToRead;
-        } while (left > 0);
+            CHECK(ProgressStatus::Update(chunk.offset, ls.Format(format, chunk.offset, objectSize)) == false, false, "");
+            CHECK(UpdateHashOnBuffer(chunk.data), false, "");
+        }
+        CHECK(chunks.HasFailed() == false, false, "");
 
         return true;
     };
@@ -152,29 +152,38 @@ bool Plugin::SetAreaToDecode(Buffer& b, BufferView& bv, uint64& start, uint64& e
 
 bool Plugin::DecodeBase64(BufferView input, uint64 start, uint64 end)
 {
-    bool warning;
+    bool warning = false;
     String message;
     Buffer output;
-    if (GView::Decoding::Base64::Decode(input, output, warning, message)) {
+    // the same area decoded again (from any window) is a lookup, areas that would decode to more than the memory budget are
+    // never kept (their key is not computed)
+    const bool shared = input.GetLength() / 4 * 3 <= DecodedObjects::GetMemoryBudget();
+    DecodedObjects::Key key{};
+    if (shared) {
+        key = DecodedObjects::ComputeKey(input, DecodedObjects::Transform::Base64);
+    }
+    if (!shared || !DecodedObjects::Find(key, output)) {
+        if (!GView::Decoding::Base64::Decode(input, output, warning, message)) {
+            AppCUI::Dialogs::MessageBox::ShowError("Error!", "Failed to decode base64!");
+            return false;
+        }
         if (warning) {
             AppCUI::Dialogs::MessageBox::ShowError("Warning!", message);
+        } else if (shared) {
+            DecodedObjects::Add(key, output);
         }
-
-        LocalString<128> name;
-        name.Format("Buffer_base64_%llx_%llx", start, end);
-
-        LocalUnicodeStringBuilder<2048> fullPath;
-        fullPath.Add(this->object->GetPath());
-        fullPath.AddChar((char16_t) std::filesystem::path::preferred_separator);
-        fullPath.Add(name);
-
-        GView::App::OpenBuffer(output, name, fullPath, GView::App::OpenMethod::BestMatch, "", this->parent);
-        return true;
     }
 
-    AppCUI::Dialogs::MessageBox::ShowError("Error!", "Failed to decode base64!");
+    LocalString<128> name;
+    name.Format("Buffer_base64_%llx_%llx", start, end);
 
-    return false;
+    LocalUnicodeStringBuilder<2048> fullPath;
+    fullPath.Add(this->object->GetPath());
+    fullPath.AddChar((char16_t) std::filesystem::path::preferred_separator);
+    fullPath.Add(name);
+
+    GView::App::OpenBuffer(output, name, fullPath, GView::App::OpenMethod::BestMatch, "", this->parent);
+    return true;
 }
 
 bool Plugin::DecodeQuotedPrintable(BufferView input, uint64 start, uint64 end)
@@ -211,9 +220,18 @@ bool Plugin::DecodeZLib(BufferView input, uint64 start, uint64 end)
     String message;
     uint64 sizeConsumed = 0;
 
+    // every stream is kept under the key of the entire area (with its offset in the area as parameter)
+    auto key = DecodedObjects::ComputeKey(input, DecodedObjects::Transform::ZLib);
+
     do {
         Buffer output;
-        if (GView::Decoding::ZLIB::DecompressStream(input, output, message, sizeConsumed)) {
+        const bool found = DecodedObjects::Find(key, output, &sizeConsumed);
+        if (found || GView::Decoding::ZLIB::DecompressStream(input, output, message, sizeConsumed)) {
+            if (!found) {
+                DecodedObjects::Add(key, output, sizeConsumed);
+            }
+            key.parameter += sizeConsumed;
+
             LocalString<128> name;
             name.Format("Buffer_zlib_%llx_%llx", start, start + sizeConsumed);
 
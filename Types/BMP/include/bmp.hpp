@@ -66,6 +66,7 @@ namespace Type
             }
 
             bool LoadImageToObject(Image& img, uint32 index) override;
+            bool LoadImageToObjectScaled(Image& img, uint32 index, uint32 divider) override;
 
             uint32 GetSelectionZonesCount() override
             {
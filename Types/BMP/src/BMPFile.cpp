@@ -32,4 +32,79 @@ bool BMPFile::LoadImageToObject(Image& img, uint32 index)
     CHECK(img.Create(bf), false, "");
 
     return true;
-}
\ No newline at end of file
+}
+bool BMPFile::LoadImageToObjectScaled(Image& img, uint32 index, uint32 divider)
+{
+    // only uncompressed bitmaps are decoded row by row (the others are loaded at full size by the viewer)
+    CHECK(infoHeader.comppresionMethod == BITMAP_COMPRESSION_METHID_BI_RGB, false, "");
+    const uint32 bpp = infoHeader.bitsPerPixel;
+    CHECK(bpp == 1 || bpp == 4 || bpp == 8 || bpp == 16 || bpp == 24 || bpp == 32, false, "Unsupported bits per pixel: %u", bpp);
+
+    auto& data         = this->obj->GetData();
+    const auto width   = static_cast<int32>(infoHeader.width);
+    const auto height  = static_cast<int32>(infoHeader.height);
+    const bool topDown = height < 0; // negative height = rows are stored from top to bottom
+    CHECK(width > 0 && height != 0 && height != INT32_MIN, false, "Invalid image size");
+
+    const uint32 rows   = static_cast<uint32>(topDown ? -height : height);
+    const uint64 stride = (((uint64) width * bpp + 31) / 32) * 4;
+    CHECK(stride <= data.GetCacheSize(), false, "Row too large: %llu bytes", stride);
+
+    // the color table (B, G, R, reserved entries) follows the info header
+    Pixel palette[256];
+    for (auto& c : palette)
+        c = Pixel(0, 0, 0, 255);
+    if (bpp <= 8)
+    {
+        const uint32 maxColors = 1U << bpp;
+        const uint32 colors    = infoHeader.numberOfColors ? std::min<uint32>(infoHeader.numberOfColors, maxColors) : maxColors;
+        auto bv                = data.Get(sizeof(Header) + infoHeader.sizeOfHeader, colors * 4, true);
+        CHECK(bv.IsValid(), false, "Unable to read the color table");
+        const uint8* p = bv.GetData();
+        for (uint32 i = 0; i < colors; i++, p += 4)
+            palette[i] = Pixel(p[2], p[1], p[0], 255);
+    }
+
+    View::ImageViewer::ImageDownscaler scaler;
+    CHECK(scaler.Init(width, rows, divider), false, "");
+    std::vector<Pixel> row(width);
+
+    for (uint32 r = 0; r < rows; r++)
+    {
+        auto bv = data.Get(header.pixelOffset + r * stride, static_cast<uint32>(stride), true);
+        CHECK(bv.IsValid(), false, "Unable to read row %u", r);
+        const uint8* p = bv.GetData();
+
+        for (int32 x = 0; x < width; x++)
+        {
+            switch (bpp)
+            {
+            case 1:
+                row[x] = palette[(p[x >> 3] >> (7 - (x & 7))) & 1];
+                break;
+            case 4:
+                row[x] = palette[(p[x >> 1] >> ((x & 1) ? 0 : 4)) & 0x0F];
+                break;
+            case 8:
+                row[x] = palette[p[x]];
+                break;
+            case 16:
+            {
+                // 5 bits per channel (X1R5G5B5)
+                const uint16 v = p[x * 2] | (p[x * 2 + 1] << 8);
+                row[x] = Pixel(((v >> 10) & 0x1F) * 255 / 31, ((v >> 5) & 0x1F) * 255 / 31, (v & 0x1F) * 255 / 31, 255);
+                break;
+            }
+            case 24:
+                row[x] = Pixel(p[x * 3 + 2], p[x * 3 + 1], p[x * 3], 255);
+                break;
+            case 32:
+                row[x] = Pixel(p[x * 4 + 2], p[x * 4 + 1], p[x * 4], 255);
+                break;
+            }
+        }
+        scaler.AddRow(topDown ? r : rows - 1 - r, row.data(), width);
+    }
+
+    return scaler.Finish(img);
+}
@@ -81,6 +81,7 @@ namespace Type
             }
 
             bool LoadImageToObject(Image& img, uint32 index) override;
+            bool LoadImageToObjectScaled(Image& img, uint32 index, uint32 divider) override;
 
           public:
             Reference<GView::Utils::SelectionZoneInterface> selectionZoneInterface;
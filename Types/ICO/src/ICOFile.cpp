@@ -67,4 +67,20 @@ bool ICOFile::LoadImageToObject(Image& img, uint32 index)
         CHECK(img.CreateFromDIB(bf, true), false, "");
     }
     return true;
-}
\ No newline at end of file
+}
+bool ICOFile::LoadImageToObjectScaled(Image& img, uint32 index, uint32 divider)
+{
+    // icons are at most 256 x 256 pixels, so the entry is decoded at full size and reduced afterwards
+    Image icon;
+    CHECK(LoadImageToObject(icon, index), false, "");
+
+    View::ImageViewer::ImageDownscaler scaler;
+    CHECK(scaler.Init(icon.GetWidth(), icon.GetHeight(), divider), false, "");
+    for (uint32 y = 0; y < icon.GetHeight(); y++)
+    {
+        for (uint32 x = 0; x < icon.GetWidth(); x++)
+            scaler.AddPixel(x, y, icon.GetPixel(x, y));
+    }
+
+    return scaler.Finish(img);
+}
@@ -1548,6 +1548,20 @@ bool PEFile::Update()
         }
     }
 
+    // the directories are parsed with many small reads --> they are loaded together in a single batch
+    GView::Utils::DataCache::Range directories[__IMAGE_NUMBEROF_DIRECTORY_ENTRIES];
+    uint32 directoriesCount = 0;
+    for (gr = 0; gr < __IMAGE_NUMBEROF_DIRECTORY_ENTRIES; gr++)
+    {
+        // the security directory (certificates) is not parsed here
+        if ((gr == (uint8) DirectoryType::Security) || (dirs[gr].VirtualAddress == 0) || (dirs[gr].Size == 0))
+            continue;
+        const auto fa = RVAToFA(dirs[gr].VirtualAddress);
+        if (fa != PE_INVALID_ADDRESS)
+            directories[directoriesCount++] = { fa, dirs[gr].Size };
+    }
+    obj->GetData().Prefetch({ directories, directoriesCount });
+
     BuildResources();   // cu erori setate
     BuildExport();      // cu erori setate
     BuildImport();      // cu erori setate
@@ -0,0 +1,97 @@
+// Microbenchmark for the PNG scanline unfilter kernels.
+// For every filter type and every bytes-per-pixel value a set of synthetic scanlines is reconstructed with the
+// scalar kernel and with the best kernel supported by the CPU. Results are checked for equality and the
+// throughput is reported in MB/s.
+
+#include "png.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+using namespace GView::Type::PNG;
+
+constexpr uint32 ROW_SIZE        = 16384; // a 4096 pixels wide RGBA image
+constexpr uint32 ROWS_COUNT      = 64;
+constexpr uint32 BENCH_ITERATION = 200;
+
+static const char* FilterName(FilterType type)
+{
+    switch (type) {
+    case FilterType::Sub:
+        return "Sub";
+    case FilterType::Up:
+        return "Up";
+    case FilterType::Average:
+        return "Average";
+    case FilterType::Paeth:
+        return "Paeth";
+    default:
+        return "None";
+    }
+}
+
+static const char* KernelName(UnfilterKernel kernel)
+{
+    switch (kernel) {
+    case UnfilterKernel::SSE2:
+        return "SSE2";
+    case UnfilterKernel::AVX2:
+        return "AVX2";
+    default:
+        return "Scalar";
+    }
+}
+
+static double Measure(UnfilterKernel kernel, FilterType filter, uint32 bpp, std::vector<uint8>& rows)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32 it = 0; it < BENCH_ITERATION; it++) {
+        for (uint32 r = 1; r < ROWS_COUNT; r++) {
+            UnfilterScanline(kernel, (uint8) filter, rows.data() + r * ROW_SIZE, rows.data() + (r - 1) * ROW_SIZE, ROW_SIZE, bpp);
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const double bytes                          = (double) ROW_SIZE * (ROWS_COUNT - 1) * BENCH_ITERATION;
+
+    return bytes / (1024.0 * 1024.0) / elapsed.count();
+}
+
+int main()
+{
+    const auto best = GetBestUnfilterKernel();
+    std::mt19937 rng(0x504E47);
+    std::vector<uint8> source((size_t) ROW_SIZE * ROWS_COUNT);
+    for (auto& b : source) {
+        b = (uint8) rng();
+    }
+
+    printf("Best kernel: %s\n", KernelName(best));
+    printf("%-8s %-4s %14s %14s %8s\n", "Filter", "BPP", "Scalar MB/s", "Best MB/s", "Speedup");
+
+    int errors = 0;
+    for (auto filter : { FilterType::Sub, FilterType::Up, FilterType::Average, FilterType::Paeth }) {
+        for (uint32 bpp : { 1, 2, 3, 4, 6, 8 }) {
+            // correctness: both kernels must reconstruct the same rows
+            auto expected = source;
+            auto actual   = source;
+            for (uint32 r = 1; r < ROWS_COUNT; r++) {
+                UnfilterScanline(UnfilterKernel::Scalar, (uint8) filter, expected.data() + r * ROW_SIZE, expected.data() + (r - 1) * ROW_SIZE, ROW_SIZE, bpp);
+                UnfilterScanline(best, (uint8) filter, actual.data() + r * ROW_SIZE, actual.data() + (r - 1) * ROW_SIZE, ROW_SIZE, bpp);
+            }
+            if (expected != actual) {
+                printf("%-8s %-4u MISMATCH between scalar and %s kernels\n", FilterName(filter), bpp, KernelName(best));
+                errors++;
+                continue;
+            }
+
+            auto rows           = source;
+            const double scalar = Measure(UnfilterKernel::Scalar, filter, bpp, rows);
+            rows                = source;
+            const double simd   = Measure(best, filter, bpp, rows);
+            printf("%-8s %-4u %14.1f %14.1f %7.2fx\n", FilterName(filter), bpp, scalar, simd, simd / scalar);
+        }
+    }
+
+    return errors == 0 ? 0 : 1;
+}
@@ -2,6 +2,15 @@
 
 #include "GView.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 namespace GView
 {
 
@@ -14,8 +23,6 @@ namespace Type
         
         #define reverseBytes32(x) (((x & 0x000000FF) << 24) | ((x & 0x0000FF00) << 8) | ((x & 0x00FF0000) >> 8) | ((x & 0xFF000000) >> 24))
 
-        #define ADD_ZONE(desc) settings.AddZone(offset, chunkSize, colors[colorIndex++], (desc))
-
         constexpr uint8_t PNG_SIGNATURE[8] = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A };
         constexpr uint8_t IHDR_CHUNK[4]    = { 0x49, 0x48, 0x44, 0x52 }; // 'IHDR'
         constexpr uint8_t IDAT_CHUNK[4]    = { 0x49, 0x44, 0x41, 0x54 }; // 'IDAT'
@@ -39,6 +46,10 @@ namespace Type
         constexpr uint32_t TEXT_CHUNK_TYPE = 0x74584574; // 'tEXt' -> 74 45 58 74
         constexpr uint32_t ZTXT_CHUNK_TYPE = 0x7458547A; // 'zTXt' -> 7A 54 58 74
         constexpr uint32_t ITXT_CHUNK_TYPE = 0x74585469; // 'iTXt' -> 69 54 58 74
+        constexpr uint32_t ACTL_CHUNK_TYPE = 0x4C546361; // 'acTL' -> 61 63 54 4C (APNG)
+        constexpr uint32_t FCTL_CHUNK_TYPE = 0x4C546366; // 'fcTL' -> 66 63 54 4C (APNG)
+        constexpr uint32_t FDAT_CHUNK_TYPE = 0x54416466; // 'fdAT' -> 66 64 41 54 (APNG)
+        constexpr uint32_t IDOT_CHUNK_TYPE = 0x544F4469; // 'iDOT' -> 69 44 4F 54 (Apple, image data split in two segments)
 
         constexpr uint8_t CRC_SIZE          = 4; // Size of the CRC field
         constexpr uint8_t CHUNK_LENGTH_SIZE = 4; // Size of the length field
@@ -89,19 +100,441 @@ namespace Type
             uint32 crc;         // CRC for the IEND chunk
         };
 
+        struct AnimationControl {
+            uint32 numFrames; // Number of frames (big endian)
+            uint32 numPlays;  // Number of times to loop the animation, 0 = infinite (big endian)
+        };
+
+        struct FrameControl {
+            uint32 sequenceNumber; // Sequence number of the animation chunk (big endian)
+            uint32 width;          // Width of the frame (big endian)
+            uint32 height;         // Height of the frame (big endian)
+            uint32 xOffset;        // X position at which to render the frame (big endian)
+            uint32 yOffset;        // Y position at which to render the frame (big endian)
+            uint16 delayNum;       // Frame delay fraction numerator (big endian)
+            uint16 delayDen;       // Frame delay fraction denominator (big endian)
+            uint8 disposeOp;       // How the frame area is disposed before rendering the next frame
+            uint8 blendOp;         // How the frame is rendered over the output buffer
+        };
+
+        struct AppleDataLayout {
+            uint32 segmentCount;        // Number of image data segments (big endian)
+            uint32 reserved;            // Always 0
+            uint32 segmentHeight;       // Height of a segment (big endian)
+            uint32 layoutSize;          // Size of the chunk including its header (big endian)
+            uint32 firstSegmentHeight;  // Rows in the first segment (big endian)
+            uint32 secondSegmentHeight; // Rows in the second segment (big endian)
+            uint32 restartOffset;       // Offset of the IDAT chunk that starts the second segment, relative to this chunk (big endian)
+        };
+
+        struct ChunkHeader {
+            uint32 length; // Length of the chunk data (big endian)
+            uint32 type;   // Chunk type, compared against the *_CHUNK_TYPE constants
+        };
+
 #pragma pack(pop) // Back to default packing
 
+        constexpr uint32 MAX_CHUNK_LENGTH    = 0x7FFFFFFF; // 2^31 - 1 (PNG specification)
+        // unknown chunks found while resynchronizing are not longer than this (bounds the CRC work done at every candidate)
+        constexpr uint32 MAX_RESYNC_CHUNK_LENGTH = 0x100000;
+        constexpr uint32 INVALID_CHUNK_INDEX = 0xFFFFFFFF;
+
+        struct ChunkInfo {
+            uint64 offset; // offset of the chunk (its length field)
+            uint32 length; // length of the chunk data
+            uint32 type;   // chunk type, compared against the *_CHUNK_TYPE constants
+            bool crcOk;    // set by PNGFile::ApplyChunksCRC
+
+            inline uint64 GetDataOffset() const
+            {
+                return offset + sizeof(ChunkHeader);
+            }
+            inline uint64 GetSize() const
+            {
+                return sizeof(ChunkHeader) + (uint64) length + CRC_SIZE;
+            }
+            inline uint64 GetEnd() const
+            {
+                return offset + GetSize();
+            }
+            inline std::string_view GetTypeName() const
+            {
+                return std::string_view(reinterpret_cast<const char*>(&type), sizeof(type));
+            }
+        };
+
+        enum class DisposeOp : uint8 { None = 0, Background = 1, Previous = 2 };
+        enum class BlendOp : uint8 { Source = 0, Over = 1 };
+
+        struct AnimationFrame {
+            uint32 width, height; // size of the frame
+            uint32 x, y;          // position of the frame on the canvas
+            uint16 delayNum, delayDen;
+            DisposeOp disposeOp;
+            BlendOp blendOp;
+            uint32 controlChunk;   // index of the fcTL chunk
+            uint32 firstDataChunk; // index of the first IDAT / fdAT chunk with the frame data
+            uint32 lastDataChunk;
+        };
+
+        struct DataRange {
+            uint64 offset;
+            uint64 size;
+        };
+
+        // true for the chunk types defined by the PNG and APNG specifications
+        bool IsKnownChunkType(uint32 type);
+
+        // Flat list of the chunks of a PNG file (in file order), built with a single sequential pass over the
+        // chunk headers. A second list keeps the chunk indexes sorted by (type, offset) so that lookups such as
+        // "next IDAT after offset X" are binary searches.
+        // Bytes that do not form a plausible chunk are skipped up to the next plausible chunk header and each
+        // contiguous run of such bytes is kept as a single unknown range.
+        class ChunkIndex
+        {
+            std::vector<ChunkInfo> chunks;
+            std::vector<uint32> byType;
+            std::vector<DataRange> unknownRanges;
+            uint64 endOffset; // offset right after the last indexed chunk
+
+            static bool ReadPlausibleChunk(GView::Utils::DataCache& data, uint64 offset, ChunkHeader& header, bool resynchronizing);
+            static bool HasValidCRC(GView::Utils::DataCache& data, uint64 offset, uint32 length);
+            static uint64 FindNextPlausibleChunk(GView::Utils::DataCache& data, uint64 offset);
+
+          public:
+            ChunkIndex();
+
+            bool Build(GView::Utils::DataCache& data, GView::Utils::ErrorList& errList);
+            void Clear();
+
+            // index of the first chunk of the given type that starts at or after `offset` (INVALID_CHUNK_INDEX if none)
+            uint32 FindNext(uint32 type, uint64 offset = 0) const;
+            // index of the chunk that contains `offset` (INVALID_CHUNK_INDEX if none)
+            uint32 FindAt(uint64 offset) const;
+            uint32 GetCountOf(uint32 type) const;
+
+            inline uint32 GetCount() const
+            {
+                return static_cast<uint32>(chunks.size());
+            }
+            inline uint64 GetEndOffset() const
+            {
+                return endOffset;
+            }
+            inline const std::vector<DataRange>& GetUnknownRanges() const
+            {
+                return unknownRanges;
+            }
+            inline ChunkInfo& operator[](uint32 index)
+            {
+                return chunks[index];
+            }
+            inline const ChunkInfo& operator[](uint32 index) const
+            {
+                return chunks[index];
+            }
+            inline std::vector<ChunkInfo>::const_iterator begin() const
+            {
+                return chunks.begin();
+            }
+            inline std::vector<ChunkInfo>::const_iterator end() const
+            {
+                return chunks.end();
+            }
+        };
+
+        enum class FilterType : uint8 { None = 0, Sub = 1, Up = 2, Average = 3, Paeth = 4 };
+        enum class UnfilterKernel : uint8 { Scalar = 0, SSE2 = 1, AVX2 = 2 };
+
+        // Reconstructs a filtered scanline in place. `previous` is the already reconstructed scanline above
+        // (all zeros for the first scanline of an image / interlace pass) and `bpp` is the number of bytes per
+        // complete pixel, rounded up to one. The first form uses the best kernel supported by the CPU.
+        bool UnfilterScanline(uint8 filterType, uint8* row, const uint8* previous, uint32 rowSize, uint32 bpp);
+        bool UnfilterScanline(UnfilterKernel kernel, uint8 filterType, uint8* row, const uint8* previous, uint32 rowSize, uint32 bpp);
+        UnfilterKernel GetBestUnfilterKernel();
+
+        // Threads shared by the parallel work of the plugin (CRC verification, segmented decoding). They are created the
+        // first time they are needed and wait for jobs for as long as the process runs.
+        class WorkerPool
+        {
+            struct Job {
+                uint64 id;
+                std::function<void()> run;
+            };
+            std::vector<std::thread> threads;
+            std::deque<Job> jobs;
+            uint64 lastId;
+            std::mutex lock;
+            std::condition_variable changed;
+
+            WorkerPool();
+            void Work();
+
+          public:
+            static WorkerPool& Get();
+
+            inline uint32 GetThreadsCount() const
+            {
+                return static_cast<uint32>(threads.size());
+            }
+            // the job runs on one of the threads, the caller does not wait for it (the id can be used to cancel it)
+            uint64 Submit(std::function<void()> job);
+            // removes a job that did not start yet, returns false if it is already running (or done)
+            bool Cancel(uint64 id);
+        };
+
+        // Runs `task(index)` for every index in [0, count) on the worker pool and on the calling thread, returns once all of
+        // them are done. Tasks are handed out one at a time in order, so they should be of roughly the same size. The
+        // calling thread takes tasks too: the loop ends even if all the threads of the pool are busy (or run the caller).
+        template <typename Task>
+        void ParallelFor(uint32 count, Task&& task)
+        {
+            const uint32 workers = std::min<uint32>(count, std::max<uint32>(1, std::thread::hardware_concurrency()));
+            if (workers <= 1) {
+                for (uint32 index = 0; index < count; index++) {
+                    task(index);
+                }
+                return;
+            }
+
+            // a helper that starts after all the tasks were handed out only touches the shared state
+            struct State {
+                std::atomic<uint32> next{ 0 };
+                uint32 done{ 0 };
+                std::mutex lock;
+                std::condition_variable finished;
+            };
+            auto state  = std::make_shared<State>();
+            auto worker = [state, count, &task]() {
+                uint32 completed = 0;
+                for (uint32 index = state->next++; index < count; index = state->next++) {
+                    task(index);
+                    completed++;
+                }
+                if (completed > 0) {
+                    std::lock_guard<std::mutex> guard(state->lock);
+                    state->done += completed;
+                    if (state->done == count) {
+                        state->finished.notify_all();
+                    }
+                }
+            };
+
+            auto& pool = WorkerPool::Get();
+            for (uint32 i = 1; i < workers && i <= pool.GetThreadsCount(); i++) {
+                pool.Submit(worker);
+            }
+            worker();
+            std::unique_lock<std::mutex> guard(state->lock);
+            state->finished.wait(guard, [&]() { return state->done == count; });
+        }
+
+        // Streaming PNG decoder: the IDAT chunks are read through the DataCache and inflated incrementally,
+        // scanlines are reconstructed one by one, so apart from the output image only two scanlines and the
+        // zlib window are kept in memory.
+        class Decoder
+        {
+            GView::Utils::DataCache& data;
+            const ChunkIndex& chunks;
+            GView::Decoding::ZLIB::StreamInflater inflater;
+
+            uint32 width;
+            uint32 height;
+            uint8 bitDepth;
+            uint8 colorType;
+            uint8 interlace;
+            uint8 channels;
+            uint32 bytesPerPixel;
+
+            Pixel palette[256];
+            uint32 paletteSize;
+            bool hasTransparentColor;
+            uint16 transparentColor[3];
+
+            uint32 nextChunk;          // index of the next chunk that was not visited yet
+            uint64 imageDataOffset;    // offset of the IDAT bytes that were not fed into the inflater
+            uint64 imageDataRemaining; // IDAT bytes left in the current chunk
+            uint32 imageDataType;      // IDAT or fdAT (APNG frames)
+
+            std::vector<uint8> scanlines; // previous + current scanline (each one prefixed by the filter byte)
+
+            // progressive rendering: every decoded pixel fills the block it stands for until a later pass refines it
+            uint32 blockWidth;
+            uint32 blockHeight;
+
+            View::ImageViewer::ImageDownscaler* downscaler; // reduced size decoding (pixels are not stored in the image)
+
+            // part of the image data that can be inflated without the data before it (written after a full flush), it is
+            // decoded straight into its rows of the image
+            struct ImageDataSegment {
+                uint32 firstChunk; // IDAT chunks [firstChunk, endChunk)
+                uint32 endChunk;
+                uint32 firstRow;
+                uint32 rows;
+                std::vector<uint8> lastLine; // last reconstructed scanline (needed if the next segment starts with an Up filter)
+            };
+
+            bool ReadHeader(const IhdrChunk& ihdr);
+            bool DecodeImageData(Image& img, Reference<View::ImageViewer::LoadImageProgressInterface> progress);
+            bool ReadPalette(const ChunkInfo& chunk);
+            bool ReadTransparency(const ChunkInfo& chunk);
+            bool ReadChunksUntilImageData();
+            bool SetImageDataChunk(const ChunkInfo& chunk);
+            bool FeedInflater();
+            bool ReadScanline(uint8* output, uint32 size);
+            bool DecodePass(Image& img, uint32 startX, uint32 startY, uint32 stepX, uint32 stepY);
+            void StoreScanline(Image& img, const uint8* row, uint32 y, uint32 startX, uint32 stepX, uint32 count) const;
+            void StorePixel(Image& img, uint32 x, uint32 y, Pixel px) const;
+            bool FindImageDataSegments(std::vector<ImageDataSegment>& segments) const;
+            bool DecodeSegments(Image& img);
+
+          public:
+            Decoder(GView::Utils::DataCache& data, const ChunkIndex& chunks);
+
+            // for interlaced images `progress` (if valid) is notified after each of the 7 Adam7 passes
+            // images written with independent deflate segments are decoded on all cores
+            bool Decode(const IhdrChunk& ihdr, Image& img, Reference<View::ImageViewer::LoadImageProgressInterface> progress = nullptr);
+            // decodes the image directly at a reduced size (each pixel is the average of a divider x divider block)
+            bool DecodeScaled(const IhdrChunk& ihdr, Image& img, uint32 divider);
+            // decodes one APNG frame (the result has the size of the frame, it is not composited on the canvas)
+            bool DecodeFrame(const IhdrChunk& ihdr, const AnimationFrame& frame, Image& img);
+        };
+
+        // structural statistics of the image data (all the counters cover the IDAT chunks that were processed so far)
+        struct ImageDataStatistics {
+            struct ChunkSizes {
+                uint64 offset;       // file offset of the IDAT chunk
+                uint32 compressed;   // size of the chunk data
+                uint64 decompressed; // bytes inflated while the data of this chunk was consumed
+            };
+            std::vector<ChunkSizes> chunks;
+            uint32 imageDataChunks; // number of IDAT chunks that will be processed
+            uint32 windowSize;      // zlib window size from the stream header (0 if the header is invalid)
+            uint64 scanlines;
+            uint64 filters[6];  // scanlines by filter type (None, Sub, Up, Average, Paeth and invalid values)
+            uint32 blocks[4];   // deflate blocks by DeflateBlockType
+            uint32 paletteSize; // palette entries (indexed-color images only)
+            uint32 usedPaletteEntries;
+            bool finished;
+            bool failed;
+        };
+
+        // Computes ImageDataStatistics on a background thread, results are published at most every 100 ms and once the
+        // last IDAT chunk is processed. The data of the object is read with DataCache::ReadAt, the only method of the cache
+        // that can be used from another thread.
+        class StatisticsWorker
+        {
+            GView::Utils::DataCache* data;
+            std::vector<ChunkInfo> imageData;
+            IhdrChunk ihdr;
+
+            std::thread thread;
+            std::mutex lock;
+            std::atomic<bool> stopRequested;
+            std::atomic<uint32> version;
+            ImageDataStatistics result;
+
+            void Run();
+            void Publish(const ImageDataStatistics& local);
+
+          public:
+            StatisticsWorker();
+            ~StatisticsWorker();
+
+            bool Start(Object* obj, const IhdrChunk& ihdr, const ChunkIndex& chunks);
+            // waits for the thread to stop, the data is not read after this call
+            void Stop();
+            // incremented every time new results are published
+            inline uint32 GetVersion() const
+            {
+                return version;
+            }
+            // the entries of chunks start with the one of the IDAT chunk firstChunk (the ones before it are already known)
+            ImageDataStatistics GetResult(size_t firstChunk = 0);
+        };
+
+        // Verifies the CRC of every chunk on the worker pool, the data is read with DataCache::ReadAt (the object cache can
+        // not be used otherwise from another thread). The results are applied by the UI thread once the pass is finished.
+        class CRCVerification
+        {
+          public:
+            struct ChunkCRC {
+                uint32 stored;
+                uint32 computed;
+                bool read; // false if the chunk could not be read
+            };
+
+          private:
+            std::vector<ChunkInfo> chunks;
+            std::vector<ChunkCRC> results;
+            std::mutex lock;
+            std::condition_variable stopped;
+            bool running;
+            uint64 job;
+            std::atomic<bool> stopRequested;
+            std::atomic<bool> finished;
+
+            void Run(GView::Utils::DataCache& data);
+
+          public:
+            CRCVerification();
+            ~CRCVerification();
+
+            bool Start(GView::Utils::DataCache& data, const ChunkIndex& chunks);
+            // a pass that did not start is dropped, a running one is waited for (it stops after the piece it reads), the
+            // data is not read after this call
+            void Stop();
+            inline bool IsFinished() const
+            {
+                return finished;
+            }
+            // one entry for every chunk of the index, valid once IsFinished returns true
+            inline const std::vector<ChunkCRC>& GetResults() const
+            {
+                return results;
+            }
+        };
+
         class PNGFile : public TypeInterface, public View::ImageViewer::LoadImageInterface
         {
+            // canvas after an animation frame was rendered (kept in a small LRU list, most recent first)
+            struct CompositedFrame {
+                uint32 index;
+                std::vector<Pixel> canvas;
+            };
+            std::list<CompositedFrame> compositedFrames;
+            // the decoded default image is shared with the other windows that show the same content; the key (a hash of
+            // the IHDR and of the chunk index with the stored CRC of every chunk) is computed the first time an image is loaded
+            GView::Utils::DecodedObjects::Key imageKey;
+            bool imageKeyComputed;
+            bool imageKeyValid;
+            CRCVerification crcVerification;
+            bool crcApplied;
+
+            // false if the image can not be shared (it would be larger than the memory budget or the key can not be read)
+            bool GetImageKey(GView::Utils::DecodedObjects::Key& key, uint32 divider);
+            bool ReadAnimationFrames();
+            bool ComposeFrame(uint32 index, std::vector<Pixel>& canvas);
+            bool LoadAnimationFrame(Image& img, uint32 index, uint32 divider);
+
           public:
             Signature signature;
             IhdrChunk ihdr;
+            ChunkIndex chunks;
+
+            // APNG: the default image (IDAT) is either the first frame or a separate image shown before the frames
+            bool isAnimated;
+            bool defaultImageIsFrame;
+            uint32 numPlays;
+            std::vector<AnimationFrame> frames;
             // sRgbChunk srgb;
             // PlteChunk plte;
             // std::list<IdatChunk> idat;
             // IendChunk iend;
 
             Reference<GView::Utils::SelectionZoneInterface> selectionZoneInterface;
+            GView::Utils::ErrorList errList;
+            StatisticsWorker statistics;
 
           public:
             PNGFile();
@@ -110,6 +543,22 @@ namespace Type
             }
 
             bool Update();
+            // starts the CRC verification of all the chunks in the background
+            bool VerifyChunksCRC();
+            // UI thread: once the verification is finished, marks the chunks and adds the invalid ones to errList (returns
+            // true only the first time, when the issues have to be shown again)
+            bool ApplyChunksCRC();
+            inline bool HasChunksCRCToApply() const
+            {
+                return !crcApplied && crcVerification.IsFinished();
+            }
+            inline bool IsChunksCRCApplied() const
+            {
+                return crcApplied;
+            }
+            // starts the statistics of the image data in the background (when they are shown for the first time)
+            bool ComputeStatistics();
+            void AddImages(View::ImageViewer::Settings& settings);
 
             std::string_view GetTypeName() override
             {
@@ -120,7 +569,15 @@ namespace Type
             {
             }
 
+            void OnObjectClose() override
+            {
+                crcVerification.Stop();
+                statistics.Stop();
+            }
+
             bool LoadImageToObject(Image& img, uint32 index) override;
+            bool LoadImageToObjectProgressive(Image& img, uint32 index, Reference<View::ImageViewer::LoadImageProgressInterface> progress) override;
+            bool LoadImageToObjectScaled(Image& img, uint32 index, uint32 divider) override;
 
             uint32 GetSelectionZonesCount() override
             {
@@ -145,6 +602,9 @@ namespace Type
 
         namespace Panels
         {
+            // how often the pages that show the results of background work check for new ones (in milliseconds)
+            constexpr uint32 REFRESH_INTERVAL = 100;
+
             class Information : public AppCUI::Controls::TabPage
             {
                 Reference<GView::Type::PNG::PNGFile> png;
@@ -159,12 +619,44 @@ namespace Type
                 Information(Reference<GView::Type::PNG::PNGFile> png);
 
                 void Update();
+                // the CRC verification runs in the background, its issues are added when the page is drawn (the timer of the
+                // page requests a repaint once the pass is finished and is stopped then)
+                virtual void Paint(AppCUI::Graphics::Renderer& renderer) override;
+                virtual bool OnTimer() override;
                 virtual void OnAfterResize(int newWidth, int newHeight) override
                 {
                     RecomputePanelsPositions();
                 }
             };
 
+
+            class Statistics : public AppCUI::Controls::TabPage
+            {
+                Reference<GView::Type::PNG::PNGFile> png;
+                Reference<AppCUI::Controls::ListView> list;
+                uint32 shownVersion;
+                bool shownFinished;
+                bool started;
+                // the rows are added once, their values are updated in place and only the new IDAT chunks are appended
+                bool rowsCreated;
+                size_t shownChunks;
+                uint64 compressed, decompressed;
+                AppCUI::Controls::ListViewItem state, window, compressedSize, decompressedSize, ratio, scanlines, usedEntries;
+                AppCUI::Controls::ListViewItem filters[6];
+                AppCUI::Controls::ListViewItem blocks[4];
+
+                void CreateRows(const ImageDataStatistics& stats);
+
+              public:
+                Statistics(Reference<GView::Type::PNG::PNGFile> png);
+
+                void Update();
+                // the statistics are started the first time the page is drawn, the results are published by a background
+                // thread and the list is refreshed when the page is drawn (the timer of the page requests a repaint when a
+                // new version is published and is stopped once the final one is shown)
+                virtual void Paint(AppCUI::Graphics::Renderer& renderer) override;
+                virtual bool OnTimer() override;
+            };
         }; // namespace Panels
 
     } // namespace PNG
@@ -0,0 +1,245 @@
+#include "png.hpp"
+
+using namespace GView::Type::PNG;
+
+// composited frames are full canvases, the LRU list keeps as many of them as fit in this budget (at least 2)
+constexpr uint64 COMPOSITED_FRAMES_MEMORY = 64 * 1024 * 1024;
+
+static Pixel BlendOver(Pixel src, Pixel dst)
+{
+    if (src.Alpha == 255 || dst.Alpha == 0) {
+        return src;
+    }
+    if (src.Alpha == 0) {
+        return dst;
+    }
+    // non premultiplied alpha: out = src * a_src + dst * a_dst * (1 - a_src)
+    const uint32 srcWeight = src.Alpha * 255;
+    const uint32 dstWeight = dst.Alpha * (255 - src.Alpha);
+    const uint32 total     = srcWeight + dstWeight;
+    auto mix               = [&](uint8 s, uint8 d) { return static_cast<uint8>((s * srcWeight + d * dstWeight) / total); };
+
+    return Pixel(mix(src.Red, dst.Red), mix(src.Green, dst.Green), mix(src.Blue, dst.Blue), static_cast<uint8>(total / 255));
+}
+
+bool PNGFile::ReadAnimationFrames()
+{
+    auto& data = this->obj->GetData();
+
+    frames.clear();
+    compositedFrames.clear();
+    isAnimated          = false;
+    defaultImageIsFrame = false;
+    numPlays            = 0;
+
+    // the acTL chunk must appear before the first IDAT, otherwise this is a regular PNG
+    const auto actl = chunks.FindNext(ACTL_CHUNK_TYPE);
+    const auto idat = chunks.FindNext(IDAT_CHUNK_TYPE);
+    if (actl == INVALID_CHUNK_INDEX || idat == INVALID_CHUNK_INDEX || actl > idat) {
+        return true;
+    }
+
+    AnimationControl control;
+    CHECK(chunks[actl].length >= sizeof(AnimationControl), false, "Invalid acTL chunk length: %u", chunks[actl].length);
+    CHECK(data.Copy<AnimationControl>(chunks[actl].GetDataOffset(), control), false, "");
+    numPlays = Endian::BigToNative(control.numPlays);
+
+    const uint32 canvasWidth  = Endian::BigToNative(ihdr.width);
+    const uint32 canvasHeight = Endian::BigToNative(ihdr.height);
+    AnimationFrame frame{};
+    bool hasFrame = false;
+
+    auto addFrame = [&]() {
+        if (hasFrame && frame.firstDataChunk != INVALID_CHUNK_INDEX) {
+            frames.push_back(frame);
+        }
+        hasFrame = false;
+    };
+
+    for (uint32 index = actl + 1; index < chunks.GetCount(); index++) {
+        const auto& chunk = chunks[index];
+
+        switch (chunk.type) {
+        case FCTL_CHUNK_TYPE: {
+            addFrame();
+
+            FrameControl fc;
+            if (chunk.length < sizeof(FrameControl) || !data.Copy<FrameControl>(chunk.GetDataOffset(), fc)) {
+                errList.AddWarning("Invalid fcTL chunk at offset 0x%llX", chunk.offset);
+                break;
+            }
+            frame.width          = Endian::BigToNative(fc.width);
+            frame.height         = Endian::BigToNative(fc.height);
+            frame.x              = Endian::BigToNative(fc.xOffset);
+            frame.y              = Endian::BigToNative(fc.yOffset);
+            frame.delayNum       = Endian::BigToNative(fc.delayNum);
+            frame.delayDen       = Endian::BigToNative(fc.delayDen);
+            frame.disposeOp      = static_cast<DisposeOp>(std::min<uint8>(fc.disposeOp, (uint8) DisposeOp::Previous));
+            frame.blendOp        = static_cast<BlendOp>(std::min<uint8>(fc.blendOp, (uint8) BlendOp::Over));
+            frame.controlChunk   = index;
+            frame.firstDataChunk = INVALID_CHUNK_INDEX;
+            frame.lastDataChunk  = INVALID_CHUNK_INDEX;
+
+            if (frame.width == 0 || frame.height == 0 || (uint64) frame.x + frame.width > canvasWidth ||
+                (uint64) frame.y + frame.height > canvasHeight) {
+                errList.AddWarning("Frame defined at offset 0x%llX is outside of the image", chunk.offset);
+                break;
+            }
+            hasFrame = true;
+            break;
+        }
+        case IDAT_CHUNK_TYPE:
+        case FDAT_CHUNK_TYPE:
+            if (!hasFrame) {
+                break; // default image that is not part of the animation (or data of an invalid frame)
+            }
+            if (frame.firstDataChunk == INVALID_CHUNK_INDEX) {
+                frame.firstDataChunk = index;
+                if (chunk.type == IDAT_CHUNK_TYPE) {
+                    defaultImageIsFrame = true;
+                }
+            }
+            frame.lastDataChunk = index;
+            break;
+        }
+    }
+    addFrame();
+
+    if (frames.size() != Endian::BigToNative(control.numFrames)) {
+        errList.AddWarning("acTL chunk declares %u frames, but %u were found", Endian::BigToNative(control.numFrames), (uint32) frames.size());
+    }
+    isAnimated = !frames.empty();
+
+    return true;
+}
+
+void PNGFile::AddImages(View::ImageViewer::Settings& settings)
+{
+    if (!isAnimated) {
+        settings.AddImage(0, this->obj->GetData().GetSize());
+        return;
+    }
+
+    if (!defaultImageIsFrame) {
+        // the default image (shown by viewers that do not support APNG) is the first image
+        const auto control = chunks.FindNext(FCTL_CHUNK_TYPE, chunks[chunks.FindNext(IDAT_CHUNK_TYPE)].offset);
+        const auto end     = control == INVALID_CHUNK_INDEX ? this->obj->GetData().GetSize() : chunks[control].offset;
+        settings.AddImage(0, end);
+    }
+    for (const auto& frame : frames) {
+        const uint64 start = chunks[frame.controlChunk].offset;
+        settings.AddImage(start, chunks[frame.lastDataChunk].GetEnd() - start);
+    }
+}
+
+bool PNGFile::ComposeFrame(uint32 index, std::vector<Pixel>& canvas)
+{
+    const uint32 canvasWidth  = Endian::BigToNative(ihdr.width);
+    const uint32 canvasHeight = Endian::BigToNative(ihdr.height);
+
+    for (auto it = compositedFrames.begin(); it != compositedFrames.end(); it++) {
+        if (it->index == index) {
+            compositedFrames.splice(compositedFrames.begin(), compositedFrames, it);
+            canvas = it->canvas;
+            return true;
+        }
+    }
+
+    // start from the closest previous composited frame (unless it must be disposed to the canvas that was before it)
+    const CompositedFrame* closest = nullptr;
+    for (const auto& c : compositedFrames) {
+        if (c.index < index && (!closest || c.index > closest->index) && frames[c.index].disposeOp != DisposeOp::Previous) {
+            closest = &c;
+        }
+    }
+
+    uint32 first = 0;
+    if (closest) {
+        canvas = closest->canvas;
+        first  = closest->index;
+    } else {
+        canvas.assign((size_t) canvasWidth * canvasHeight, Pixel(0, 0, 0, 0));
+    }
+
+    std::vector<Pixel> previous;
+    for (uint32 k = first; k <= index; k++) {
+        const auto& frame = frames[k];
+
+        if (closest && k == first) {
+            // `closest` was already rendered, only its disposal is needed
+        } else {
+            if (frame.disposeOp == DisposeOp::Previous) {
+                previous = canvas;
+            }
+
+            Image img;
+            Decoder decoder(this->obj->GetData(), chunks);
+            CHECK(decoder.DecodeFrame(ihdr, frame, img), false, "Fail to decode frame %u", k);
+
+            for (uint32 y = 0; y < frame.height; y++) {
+                Pixel* row = canvas.data() + (size_t) (frame.y + y) * canvasWidth + frame.x;
+                for (uint32 x = 0; x < frame.width; x++) {
+                    const auto px = img.GetPixel(x, y);
+                    row[x]        = frame.blendOp == BlendOp::Source ? px : BlendOver(px, row[x]);
+                }
+            }
+        }
+        if (k == index) {
+            break;
+        }
+
+        // dispose the frame area before rendering the next frame
+        switch (frame.disposeOp) {
+        case DisposeOp::Background:
+            for (uint32 y = 0; y < frame.height; y++) {
+                std::fill_n(canvas.data() + (size_t) (frame.y + y) * canvasWidth + frame.x, frame.width, Pixel(0, 0, 0, 0));
+            }
+            break;
+        case DisposeOp::Previous:
+            if (previous.empty()) {
+                previous.assign((size_t) canvasWidth * canvasHeight, Pixel(0, 0, 0, 0));
+            }
+            std::swap(canvas, previous);
+            break;
+        default:
+            break;
+        }
+    }
+
+    const uint64 frameSize = (uint64) canvasWidth * canvasHeight * sizeof(Pixel);
+    const uint64 capacity  = std::max<uint64>(2, COMPOSITED_FRAMES_MEMORY / std::max<uint64>(1, frameSize));
+    compositedFrames.push_front({ index, canvas });
+    while (compositedFrames.size() > capacity) {
+        compositedFrames.pop_back();
+    }
+
+    return true;
+}
+
+bool PNGFile::LoadAnimationFrame(Image& img, uint32 index, uint32 divider)
+{
+    CHECK(index < frames.size(), false, "Invalid frame index: %u", index);
+
+    const uint32 canvasWidth  = Endian::BigToNative(ihdr.width);
+    const uint32 canvasHeight = Endian::BigToNative(ihdr.height);
+    std::vector<Pixel> canvas;
+    CHECK(ComposeFrame(index, canvas), false, "");
+
+    if (divider > 1) {
+        View::ImageViewer::ImageDownscaler scaler;
+        CHECK(scaler.Init(canvasWidth, canvasHeight, divider), false, "");
+        for (uint32 y = 0; y < canvasHeight; y++) {
+            scaler.AddRow(y, canvas.data() + (size_t) y * canvasWidth, canvasWidth);
+        }
+        return scaler.Finish(img);
+    }
+
+    CHECK(img.Create(canvasWidth, canvasHeight), false, "Fail to create a %u x %u image", canvasWidth, canvasHeight);
+    const Pixel* px = canvas.data();
+    for (uint32 y = 0; y < canvasHeight; y++) {
+        for (uint32 x = 0; x < canvasWidth; x++, px++) {
+            img.SetPixel(x, y, *px);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,158 @@
+#include "png.hpp"
+
+using namespace GView::Type::PNG;
+using namespace GView::Hashes;
+
+// large chunks (usually IDAT) are split in pieces of this size so that their CRC can be computed on several threads
+constexpr uint32 CRC_PIECE_SIZE = 0x40000;
+
+struct CRCPiece {
+    uint32 chunk;  // index in the chunk index
+    uint64 offset; // file offset of the first byte covered by this piece
+    uint32 size;
+    uint32 crc;
+};
+
+static uint32 ComputeCRC(const uint8* buffer, uint32 size)
+{
+    CRC32 crc;
+    uint32 result = 0;
+    crc.Init(CRC32Type::JAMCRC);
+    crc.Update(buffer, size);
+    crc.Final(result);
+    return result;
+}
+
+CRCVerification::CRCVerification() : running(false), job(0), stopRequested(false), finished(false)
+{
+}
+
+CRCVerification::~CRCVerification()
+{
+    Stop();
+}
+
+bool CRCVerification::Start(GView::Utils::DataCache& data, const ChunkIndex& _chunks)
+{
+    Stop();
+
+    // the chunk index of the object is copied, it is never used from the worker pool
+    chunks.assign(_chunks.begin(), _chunks.end());
+    results.clear();
+    stopRequested = false;
+    finished      = false;
+    running       = true;
+    job           = WorkerPool::Get().Submit([this, &data]() {
+        Run(data);
+        std::lock_guard<std::mutex> guard(lock);
+        running = false;
+        stopped.notify_all();
+    });
+    return true;
+}
+
+void CRCVerification::Stop()
+{
+    stopRequested = true;
+    std::unique_lock<std::mutex> guard(lock);
+    if (!running) {
+        return;
+    }
+    // a pass queued behind the jobs of other objects is dropped at once, only a running one is waited for
+    if (WorkerPool::Get().Cancel(job)) {
+        running = false;
+        return;
+    }
+    stopped.wait(guard, [this]() { return !running; });
+}
+
+void CRCVerification::Run(GView::Utils::DataCache& data)
+{
+    std::vector<CRCPiece> pieces;
+    std::vector<ChunkCRC> computed(chunks.size(), ChunkCRC{ 0, 0, true });
+
+    // the CRC covers the chunk type and the chunk data
+    for (uint32 index = 0; index < chunks.size(); index++) {
+        const auto& chunk = chunks[index];
+        const uint64 end  = chunk.GetDataOffset() + chunk.length;
+        for (uint64 pos = chunk.offset + CHUNK_LENGTH_SIZE; pos < end; pos += CRC_PIECE_SIZE) {
+            pieces.push_back({ index, pos, (uint32) std::min<uint64>(CRC_PIECE_SIZE, end - pos), 0 });
+        }
+    }
+
+    // every piece is read on its own (ReadAt does not use the cached pages) and its CRC is computed in parallel
+    std::vector<std::atomic<bool>> unreadable(chunks.size());
+    ParallelFor(static_cast<uint32>(pieces.size()), [&](uint32 index) {
+        if (stopRequested) {
+            return;
+        }
+        auto& piece = pieces[index];
+        std::vector<uint8> buffer(piece.size);
+        if (!data.ReadAt(piece.offset, std::span<uint8>(buffer))) {
+            unreadable[piece.chunk] = true;
+            return;
+        }
+        piece.crc = ComputeCRC(buffer.data(), piece.size);
+    });
+    if (stopRequested) {
+        return;
+    }
+
+    // the CRCs of the pieces of a chunk are merged in order
+    for (uint32 i = 0; i < pieces.size();) {
+        auto& crc = computed[pieces[i].chunk].computed;
+        crc       = pieces[i].crc;
+        for (i++; i < pieces.size() && pieces[i].chunk == pieces[i - 1].chunk; i++) {
+            crc = CRC32::Combine(crc, pieces[i].crc, pieces[i].size);
+        }
+    }
+
+    for (uint32 index = 0; index < chunks.size(); index++) {
+        if (stopRequested) {
+            return;
+        }
+        const auto& chunk = chunks[index];
+        auto& result      = computed[index];
+        uint32 stored     = 0;
+        result.read       = !unreadable[index] && data.ReadAt(chunk.GetDataOffset() + chunk.length, std::span<uint8>((uint8*) &stored, sizeof(stored)));
+        result.stored     = Endian::BigToNative(stored);
+    }
+
+    results  = std::move(computed);
+    finished = true;
+}
+
+bool PNGFile::VerifyChunksCRC()
+{
+    crcApplied = false;
+    return crcVerification.Start(this->obj->GetData(), chunks);
+}
+
+bool PNGFile::ApplyChunksCRC()
+{
+    if (crcApplied || !crcVerification.IsFinished()) {
+        return false;
+    }
+    crcApplied = true;
+
+    const auto& results = crcVerification.GetResults();
+    for (uint32 index = 0; index < chunks.GetCount() && index < results.size(); index++) {
+        auto& chunk        = chunks[index];
+        const auto& result = results[index];
+        const auto name    = chunk.GetTypeName();
+
+        chunk.crcOk = result.read && result.stored == result.computed;
+        if (!result.read) {
+            errList.AddError("Unable to read the %.*s chunk at offset 0x%llX to verify its CRC", (int) name.size(), name.data(), chunk.offset);
+        } else if (!chunk.crcOk) {
+            errList.AddError(
+                  "Invalid CRC for %.*s chunk at offset 0x%llX (stored: 0x%08X, computed: 0x%08X)",
+                  (int) name.size(),
+                  name.data(),
+                  chunk.offset,
+                  result.stored,
+                  result.computed);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,273 @@
+#include "png.hpp"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#    define PNG_RESYNC_X64
+#    include <immintrin.h>
+#    ifdef _MSC_VER
+#        include <intrin.h>
+#    endif
+#endif
+
+using namespace GView::Type::PNG;
+
+bool GView::Type::PNG::IsKnownChunkType(uint32 type)
+{
+    switch (type) {
+    case IHDR_CHUNK_TYPE:
+    case SRGB_CHUNK_TYPE:
+    case PLTE_CHUNK_TYPE:
+    case IDAT_CHUNK_TYPE:
+    case IEND_CHUNK_TYPE:
+    case CHRM_CHUNK_TYPE:
+    case GAMA_CHUNK_TYPE:
+    case ICCP_CHUNK_TYPE:
+    case SBIT_CHUNK_TYPE:
+    case BKGD_CHUNK_TYPE:
+    case HIST_CHUNK_TYPE:
+    case TRNS_CHUNK_TYPE:
+    case PHYS_CHUNK_TYPE:
+    case SPLT_CHUNK_TYPE:
+    case TIME_CHUNK_TYPE:
+    case TEXT_CHUNK_TYPE:
+    case ZTXT_CHUNK_TYPE:
+    case ITXT_CHUNK_TYPE:
+    case ACTL_CHUNK_TYPE:
+    case FCTL_CHUNK_TYPE:
+    case FDAT_CHUNK_TYPE:
+    case IDOT_CHUNK_TYPE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static inline bool IsChunkTypeLetter(uint8 c)
+{
+    return static_cast<uint8>((c | 0x20) - 'a') < 26;
+}
+
+static bool IsValidChunkType(uint32 type)
+{
+    const auto bytes = reinterpret_cast<const uint8*>(&type);
+    return IsChunkTypeLetter(bytes[0]) && IsChunkTypeLetter(bytes[1]) && IsChunkTypeLetter(bytes[2]) && IsChunkTypeLetter(bytes[3]);
+}
+
+#ifdef PNG_RESYNC_X64
+static inline uint32 LowestSetBit(uint32 mask)
+{
+#    ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#    else
+    return __builtin_ctz(mask);
+#    endif
+}
+
+// 0xFF for every byte that is an ASCII letter: (c | 0x20) - 'a' is moved to [-128, -103] for letters
+// so that a single signed compare checks the whole range
+static inline __m128i LetterMask(const uint8* buffer)
+{
+    const __m128i value = _mm_add_epi8(_mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer)), _mm_set1_epi8(0x20)), _mm_set1_epi8((char) (0x80 - 'a')));
+    return _mm_cmpgt_epi8(_mm_set1_epi8(-128 + 26), value);
+}
+#endif
+
+// position of the first 4 consecutive ASCII letters from buffer (a possible chunk type) or `size` if there is none
+static uint32 FindChunkTypeCandidate(const uint8* buffer, uint32 size)
+{
+    uint32 pos = 0;
+#ifdef PNG_RESYNC_X64
+    // 16 positions are tested at once: position i is a candidate if bytes i .. i+3 are all letters
+    for (; pos + 19 <= size; pos += 16) {
+        const __m128i letters = _mm_and_si128(
+              _mm_and_si128(LetterMask(buffer + pos), LetterMask(buffer + pos + 1)), _mm_and_si128(LetterMask(buffer + pos + 2), LetterMask(buffer + pos + 3)));
+        const uint32 mask = static_cast<uint32>(_mm_movemask_epi8(letters));
+        if (mask) {
+            return pos + LowestSetBit(mask);
+        }
+    }
+#endif
+    for (; pos + 4 <= size; pos++) {
+        if (IsChunkTypeLetter(buffer[pos]) && IsChunkTypeLetter(buffer[pos + 1]) && IsChunkTypeLetter(buffer[pos + 2]) &&
+            IsChunkTypeLetter(buffer[pos + 3])) {
+            return pos;
+        }
+    }
+    return size;
+}
+
+ChunkIndex::ChunkIndex()
+{
+    endOffset = 0;
+}
+
+void ChunkIndex::Clear()
+{
+    chunks.clear();
+    byType.clear();
+    unknownRanges.clear();
+    endOffset = 0;
+}
+
+bool ChunkIndex::HasValidCRC(GView::Utils::DataCache& data, uint64 offset, uint32 length)
+{
+    const uint32 window = data.GetCacheSize();
+    const uint64 end    = offset + sizeof(ChunkHeader) + length;
+
+    // the CRC covers the chunk type and the chunk data
+    GView::Hashes::CRC32 crc;
+    CHECK(crc.Init(GView::Hashes::CRC32Type::JAMCRC), false, "");
+    for (uint64 pos = offset + CHUNK_LENGTH_SIZE; pos < end;) {
+        const auto size = static_cast<uint32>(std::min<uint64>(window, end - pos));
+        auto bv         = data.Get(pos, size, true);
+        CHECK(bv.IsValid(), false, "Unable to read %u bytes from offset %llu", size, pos);
+        CHECK(crc.Update(bv.GetData(), size), false, "");
+        pos += size;
+    }
+
+    uint32 computed = 0;
+    uint32 stored   = 0;
+    CHECK(crc.Final(computed), false, "");
+    CHECK(data.Copy<uint32>(end, stored), false, "");
+    return Endian::BigToNative(stored) == computed;
+}
+
+static bool IsPlausibleHeader(GView::Utils::DataCache& data, uint64 offset, ChunkHeader& header, uint32 maxLength)
+{
+    const uint64 size = data.GetSize();
+    if (offset + sizeof(ChunkHeader) + CRC_SIZE > size || !data.Copy<ChunkHeader>(offset, header)) {
+        return false;
+    }
+    const uint32 length = Endian::BigToNative(header.length);
+    return length <= maxLength && offset + sizeof(ChunkHeader) + length + CRC_SIZE <= size && IsValidChunkType(header.type);
+}
+
+bool ChunkIndex::ReadPlausibleChunk(GView::Utils::DataCache& data, uint64 offset, ChunkHeader& header, bool resynchronizing)
+{
+    if (!IsPlausibleHeader(data, offset, header, MAX_CHUNK_LENGTH)) {
+        return false;
+    }
+    // a known type is enough (a wrong CRC is reported later), an unknown chunk is taken whole only if its CRC matches
+    if (IsKnownChunkType(header.type)) {
+        return true;
+    }
+    const uint32 length = Endian::BigToNative(header.length);
+    if (resynchronizing) {
+        // garbage has many candidates: the CRC is computed only for short chunks followed by another plausible header (or by
+        // the end of the file), so that a candidate costs a few reads instead of one pass over its declared length
+        const uint64 next = offset + sizeof(ChunkHeader) + length + CRC_SIZE;
+        ChunkHeader nextHeader;
+        if (length > MAX_RESYNC_CHUNK_LENGTH || (next < data.GetSize() && !IsPlausibleHeader(data, next, nextHeader, MAX_CHUNK_LENGTH))) {
+            return false;
+        }
+    }
+    return HasValidCRC(data, offset, length);
+}
+
+uint64 ChunkIndex::FindNextPlausibleChunk(GView::Utils::DataCache& data, uint64 offset)
+{
+    const uint64 size   = data.GetSize();
+    const uint32 window = data.GetCacheSize();
+
+    // the chunk type is the first field that can be recognized, the chunk starts CHUNK_LENGTH_SIZE bytes before it
+    for (uint64 pos = offset + 1 + CHUNK_LENGTH_SIZE; pos + CHUNK_TYPE_SIZE + CRC_SIZE <= size;) {
+        const auto count = static_cast<uint32>(std::min<uint64>(window, size - pos));
+        auto bv          = data.Get(pos, count, false);
+        CHECK(bv.IsValid() && bv.GetLength() >= CHUNK_TYPE_SIZE, size, "Unable to read data from offset %llu", pos);
+
+        const uint32 candidate = FindChunkTypeCandidate(bv.GetData(), static_cast<uint32>(bv.GetLength()));
+        if (candidate + CHUNK_TYPE_SIZE > bv.GetLength()) {
+            // the last bytes of the window can still be the start of a chunk type
+            pos += bv.GetLength() - (CHUNK_TYPE_SIZE - 1);
+            continue;
+        }
+
+        ChunkHeader header;
+        const uint64 chunkOffset = pos + candidate - CHUNK_LENGTH_SIZE;
+        if (ReadPlausibleChunk(data, chunkOffset, header, true)) {
+            return chunkOffset;
+        }
+        pos += candidate + 1;
+    }
+    return size;
+}
+
+bool ChunkIndex::Build(GView::Utils::DataCache& data, GView::Utils::ErrorList& errList)
+{
+    Clear();
+
+    const uint64 size = data.GetSize();
+    uint64 offset     = sizeof(Signature);
+
+    while (offset + sizeof(ChunkHeader) + CRC_SIZE <= size) {
+        ChunkHeader header;
+        if (!ReadPlausibleChunk(data, offset, header, false)) {
+            // everything up to the next plausible chunk header is a single unknown range
+            const uint64 next = FindNextPlausibleChunk(data, offset);
+            if (next >= size) {
+                errList.AddError("Invalid chunk at offset 0x%llX (no valid chunk was found after it)", offset);
+                break;
+            }
+            errList.AddWarning("%llu bytes of unknown data at offset 0x%llX", next - offset, offset);
+            unknownRanges.push_back({ offset, next - offset });
+            offset = next;
+            continue;
+        }
+
+        chunks.push_back({ offset, Endian::BigToNative(header.length), header.type, false });
+        offset += chunks.back().GetSize();
+
+        if (header.type == IEND_CHUNK_TYPE) {
+            break;
+        }
+    }
+    endOffset = offset;
+
+    byType.resize(chunks.size());
+    for (uint32 i = 0; i < chunks.size(); i++) {
+        byType[i] = i;
+    }
+    // chunks are already sorted by offset, so (type, index) gives the same order as (type, offset)
+    std::sort(byType.begin(), byType.end(), [this](uint32 a, uint32 b) {
+        return chunks[a].type != chunks[b].type ? chunks[a].type < chunks[b].type : a < b;
+    });
+
+    CHECK(chunks.size() > 0, false, "No chunks found");
+    CHECK(chunks[0].type == IHDR_CHUNK_TYPE, false, "The first chunk is not IHDR");
+
+    return true;
+}
+
+uint32 ChunkIndex::FindNext(uint32 type, uint64 offset) const
+{
+    auto it = std::lower_bound(byType.begin(), byType.end(), std::make_pair(type, offset), [this](uint32 index, const std::pair<uint32, uint64>& key) {
+        const auto& chunk = chunks[index];
+        return chunk.type != key.first ? chunk.type < key.first : chunk.offset < key.second;
+    });
+    if (it == byType.end() || chunks[*it].type != type) {
+        return INVALID_CHUNK_INDEX;
+    }
+    return *it;
+}
+
+uint32 ChunkIndex::FindAt(uint64 offset) const
+{
+    // first chunk that starts after `offset`, the one before it is the only candidate
+    auto it = std::upper_bound(chunks.begin(), chunks.end(), offset, [](uint64 value, const ChunkInfo& chunk) { return value < chunk.offset; });
+    if (it == chunks.begin()) {
+        return INVALID_CHUNK_INDEX;
+    }
+    --it;
+    if (offset >= it->GetEnd()) {
+        return INVALID_CHUNK_INDEX;
+    }
+    return static_cast<uint32>(it - chunks.begin());
+}
+
+uint32 ChunkIndex::GetCountOf(uint32 type) const
+{
+    auto first = std::partition_point(byType.begin(), byType.end(), [this, type](uint32 index) { return chunks[index].type < type; });
+    auto last  = std::partition_point(first, byType.end(), [this, type](uint32 index) { return chunks[index].type == type; });
+    return static_cast<uint32>(last - first);
+}
@@ -0,0 +1,609 @@
+#include "png.hpp"
+
+using namespace GView::Type::PNG;
+
+constexpr uint32 MAX_PALETTE_ENTRIES = 256;
+
+// a flush ends the deflate data with an empty stored block (LEN = 0, NLEN = 0xFFFF)
+constexpr uint32 DEFLATE_FLUSH_MARKER = 0x0000FFFF;
+// a back reference can not point further than the deflate window
+constexpr uint32 DEFLATE_WINDOW_SIZE = 0x8000;
+// the IDAT data of a segment is read in blocks of this size
+constexpr uint32 SEGMENT_READ_SIZE = 0x10000;
+
+// Adam7 interlace passes: starting column/row and the distance between two pixels of the same pass
+constexpr uint32 ADAM7_START_X[7] = { 0, 4, 0, 2, 0, 1, 0 };
+constexpr uint32 ADAM7_START_Y[7] = { 0, 0, 4, 0, 2, 0, 1 };
+constexpr uint32 ADAM7_STEP_X[7]  = { 8, 8, 4, 4, 2, 2, 1 };
+constexpr uint32 ADAM7_STEP_Y[7]  = { 8, 8, 8, 4, 4, 2, 2 };
+// area covered by a pixel of each pass until the following passes are decoded (used for progressive rendering)
+constexpr uint32 ADAM7_BLOCK_WIDTH[7]  = { 8, 4, 4, 2, 2, 1, 1 };
+constexpr uint32 ADAM7_BLOCK_HEIGHT[7] = { 8, 8, 4, 4, 2, 2, 1 };
+
+static uint8 ChannelsForColorType(uint8 colorType)
+{
+    switch (colorType) {
+    case 0: // Grayscale
+    case 3: // Indexed-color
+        return 1;
+    case 2: // Truecolor
+        return 3;
+    case 4: // Grayscale with alpha
+        return 2;
+    case 6: // Truecolor with alpha
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+static bool IsValidBitDepth(uint8 colorType, uint8 bitDepth)
+{
+    switch (colorType) {
+    case 0:
+        return bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8 || bitDepth == 16;
+    case 3:
+        return bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8;
+    case 2:
+    case 4:
+    case 6:
+        return bitDepth == 8 || bitDepth == 16;
+    default:
+        return false;
+    }
+}
+
+Decoder::Decoder(GView::Utils::DataCache& _data, const ChunkIndex& _chunks) : data(_data), chunks(_chunks)
+{
+    width               = 0;
+    height              = 0;
+    bitDepth            = 0;
+    colorType           = 0;
+    interlace           = 0;
+    channels            = 0;
+    bytesPerPixel       = 0;
+    paletteSize         = 0;
+    hasTransparentColor = false;
+    nextChunk           = 0;
+    imageDataOffset     = 0;
+    imageDataRemaining  = 0;
+    imageDataType       = IDAT_CHUNK_TYPE;
+    blockWidth          = 1;
+    blockHeight         = 1;
+    downscaler          = nullptr;
+    memset(transparentColor, 0, sizeof(transparentColor));
+}
+
+bool Decoder::ReadPalette(const ChunkInfo& chunk)
+{
+    CHECK(chunk.length % 3 == 0, false, "Invalid PLTE chunk length: %u", chunk.length);
+    paletteSize = std::min<uint32>(chunk.length / 3, MAX_PALETTE_ENTRIES);
+    auto bv     = data.Get(chunk.GetDataOffset(), paletteSize * 3, true);
+    CHECK(bv.IsValid(), false, "Unable to read the palette");
+    const uint8* p = bv.GetData();
+    for (uint32 i = 0; i < paletteSize; i++, p += 3) {
+        palette[i] = Pixel(p[0], p[1], p[2], 255);
+    }
+    return true;
+}
+
+bool Decoder::ReadTransparency(const ChunkInfo& chunk)
+{
+    if (chunk.length == 0) {
+        return true;
+    }
+    auto bv = data.Get(chunk.GetDataOffset(), chunk.length, true);
+    CHECK(bv.IsValid(), false, "Unable to read the tRNS chunk");
+    const uint8* p = bv.GetData();
+    if (colorType == 3) {
+        // alpha values for the first palette entries
+        const auto count = std::min<uint32>((uint32) bv.GetLength(), paletteSize);
+        for (uint32 i = 0; i < count; i++) {
+            palette[i].Alpha = p[i];
+        }
+    } else if ((colorType == 0 && chunk.length >= 2) || (colorType == 2 && chunk.length >= 6)) {
+        // a single color (16 bits per sample) that must be considered fully transparent
+        for (uint32 i = 0; i < chunk.length / 2 && i < 3; i++) {
+            transparentColor[i] = ((uint16) p[i * 2] << 8) | p[i * 2 + 1];
+        }
+        hasTransparentColor = true;
+    }
+    return true;
+}
+
+bool Decoder::ReadChunksUntilImageData()
+{
+    // PLTE and tRNS are only meaningful before the first IDAT chunk (and PLTE must precede tRNS)
+    const auto idat = chunks.FindNext(IDAT_CHUNK_TYPE);
+    CHECK(idat != INVALID_CHUNK_INDEX, false, "No IDAT chunk found");
+
+    const auto plte = chunks.FindNext(PLTE_CHUNK_TYPE);
+    if (plte < idat) {
+        CHECK(ReadPalette(chunks[plte]), false, "");
+    }
+    const auto trns = chunks.FindNext(TRNS_CHUNK_TYPE);
+    if (trns < idat) {
+        CHECK(ReadTransparency(chunks[trns]), false, "");
+    }
+
+    imageDataType = IDAT_CHUNK_TYPE;
+    nextChunk     = idat + 1;
+    CHECK(SetImageDataChunk(chunks[idat]), false, "");
+
+    return true;
+}
+
+bool Decoder::SetImageDataChunk(const ChunkInfo& chunk)
+{
+    imageDataOffset    = chunk.GetDataOffset();
+    imageDataRemaining = chunk.length;
+    if (chunk.type == FDAT_CHUNK_TYPE) {
+        // fdAT data is prefixed by the sequence number
+        CHECK(chunk.length >= sizeof(uint32), false, "Invalid fdAT chunk length: %u", chunk.length);
+        imageDataOffset += sizeof(uint32);
+        imageDataRemaining -= sizeof(uint32);
+    }
+    return true;
+}
+
+bool Decoder::FeedInflater()
+{
+    // image data is split into consecutive IDAT (or fdAT) chunks that form a single zlib stream
+    while (imageDataRemaining == 0) {
+        CHECK(nextChunk < chunks.GetCount() && chunks[nextChunk].type == imageDataType, false, "Image data ended before all scanlines were decoded");
+        CHECK(SetImageDataChunk(chunks[nextChunk]), false, "");
+        nextChunk++;
+    }
+
+    const auto size = static_cast<uint32>(std::min<uint64>(imageDataRemaining, data.GetCacheSize() >> 1));
+    auto bv         = data.Get(imageDataOffset, size, true);
+    CHECK(bv.IsValid(), false, "Unable to read %u bytes of image data from offset %llu", size, imageDataOffset);
+
+    inflater.SetInput(bv);
+    imageDataOffset += size;
+    imageDataRemaining -= size;
+
+    return true;
+}
+
+bool Decoder::ReadScanline(uint8* output, uint32 size)
+{
+    while (size > 0) {
+        if (inflater.NeedsInput()) {
+            CHECK(FeedInflater(), false, "");
+        }
+        uint32 written = 0;
+        CHECK(inflater.Inflate(output, size, written), false, "");
+        CHECK(written > 0 || inflater.IsFinished() == false, false, "Compressed image data ended prematurely");
+        output += written;
+        size -= written;
+    }
+    return true;
+}
+
+void Decoder::StoreScanline(Image& img, const uint8* row, uint32 y, uint32 startX, uint32 stepX, uint32 count) const
+{
+    const uint32 sampleMask = (1U << std::min<uint32>(bitDepth, 8)) - 1;
+
+    for (uint32 i = 0, x = startX; i < count; i++, x += stepX) {
+        Pixel px;
+
+        if (bitDepth < 8) {
+            // packed samples (grayscale or palette index), most significant bits first
+            const uint32 bitOffset = i * bitDepth;
+            const uint32 value     = (row[bitOffset >> 3] >> (8 - bitDepth - (bitOffset & 7))) & sampleMask;
+            if (colorType == 3) {
+                px = value < paletteSize ? palette[value] : Pixel(0, 0, 0, 255);
+            } else {
+                const auto gray = static_cast<uint8>(value * 255 / sampleMask);
+                const uint8 alpha = (hasTransparentColor && value == transparentColor[0]) ? 0 : 255;
+                px                = Pixel(gray, gray, gray, alpha);
+            }
+            StorePixel(img, x, y, px);
+            continue;
+        }
+
+        // for 16 bits per sample only the most significant byte is kept
+        const uint8* p       = row + i * bytesPerPixel;
+        const uint32 advance = bitDepth == 16 ? 2 : 1;
+        auto sample          = [&](uint32 index) -> uint16 {
+            return bitDepth == 16 ? (((uint16) p[index * 2] << 8) | p[index * 2 + 1]) : p[index];
+        };
+
+        switch (colorType) {
+        case 0:
+            px = Pixel(p[0], p[0], p[0], (hasTransparentColor && sample(0) == transparentColor[0]) ? 0 : 255);
+            break;
+        case 2: {
+            const bool transparent = hasTransparentColor && sample(0) == transparentColor[0] && sample(1) == transparentColor[1] &&
+                                     sample(2) == transparentColor[2];
+            px = Pixel(p[0], p[advance], p[advance * 2], transparent ? 0 : 255);
+            break;
+        }
+        case 3:
+            px = p[0] < paletteSize ? palette[p[0]] : Pixel(0, 0, 0, 255);
+            break;
+        case 4:
+            px = Pixel(p[0], p[0], p[0], p[advance]);
+            break;
+        case 6:
+            px = Pixel(p[0], p[advance], p[advance * 2], p[advance * 3]);
+            break;
+        }
+        StorePixel(img, x, y, px);
+    }
+}
+
+void Decoder::StorePixel(Image& img, uint32 x, uint32 y, Pixel px) const
+{
+    if (downscaler) {
+        downscaler->AddPixel(x, y, px);
+        return;
+    }
+    if (blockWidth == 1 && blockHeight == 1) {
+        img.SetPixel(x, y, px);
+        return;
+    }
+    const uint32 endX = std::min<uint32>(x + blockWidth, width);
+    const uint32 endY = std::min<uint32>(y + blockHeight, height);
+    for (uint32 by = y; by < endY; by++) {
+        for (uint32 bx = x; bx < endX; bx++) {
+            img.SetPixel(bx, by, px);
+        }
+    }
+}
+
+bool Decoder::DecodePass(Image& img, uint32 startX, uint32 startY, uint32 stepX, uint32 stepY)
+{
+    if (startX >= width || startY >= height) {
+        return true; // empty pass (possible for very small interlaced images)
+    }
+
+    const uint32 passWidth = (width - startX + stepX - 1) / stepX;
+    const uint64 rowSize   = ((uint64) passWidth * channels * bitDepth + 7) / 8;
+    CHECK(rowSize < 0x7FFFFFFF, false, "Scanline too large: %llu bytes", rowSize);
+
+    // each scanline is prefixed by its filter type byte
+    const uint32 lineSize = static_cast<uint32>(rowSize) + 1;
+    scanlines.assign((size_t) lineSize * 2, 0);
+    uint8* previous = scanlines.data();
+    uint8* current  = scanlines.data() + lineSize;
+
+    for (uint32 y = startY; y < height; y += stepY) {
+        CHECK(ReadScanline(current, lineSize), false, "Fail to read scanline %u", y);
+        CHECK(UnfilterScanline(current[0], current + 1, previous + 1, lineSize - 1, bytesPerPixel), false, "Scanline %u", y);
+        StoreScanline(img, current + 1, y, startX, stepX, passWidth);
+        std::swap(previous, current);
+    }
+
+    return true;
+}
+
+// The IDAT data can be split in segments that do not reference each other if the encoder used a full flush at an
+// IDAT chunk boundary. The iDOT chunk lists the chunk that starts the second segment and the rows of both segments;
+// without it the segments start at the chunks that follow a chunk ending with a flush marker (a sync flush writes the
+// same marker, so these are only candidates) and their rows are not known. Returns true if the rows are known.
+bool Decoder::FindImageDataSegments(std::vector<ImageDataSegment>& segments) const
+{
+    segments.clear();
+    const auto first = chunks.FindNext(IDAT_CHUNK_TYPE);
+    if (first == INVALID_CHUNK_INDEX) {
+        return false;
+    }
+    uint32 end = first + 1;
+    while (end < chunks.GetCount() && chunks[end].type == IDAT_CHUNK_TYPE) {
+        end++;
+    }
+
+    const auto idot = chunks.FindNext(IDOT_CHUNK_TYPE);
+    AppleDataLayout layout;
+    if (idot != INVALID_CHUNK_INDEX && chunks[idot].length >= sizeof(AppleDataLayout) &&
+        data.Copy<AppleDataLayout>(chunks[idot].GetDataOffset(), layout)) {
+        const uint64 offset       = chunks[idot].offset + Endian::BigToNative(layout.restartOffset);
+        const auto restart        = chunks.FindAt(offset);
+        const uint32 firstHeight  = Endian::BigToNative(layout.firstSegmentHeight);
+        const uint32 secondHeight = Endian::BigToNative(layout.secondSegmentHeight);
+        if (Endian::BigToNative(layout.segmentCount) == 2 && restart > first && restart < end && chunks[restart].offset == offset &&
+            firstHeight > 0 && secondHeight > 0 && (uint64) firstHeight + secondHeight == height) {
+            segments.push_back({ first, restart, 0, firstHeight });
+            segments.push_back({ restart, end, firstHeight, secondHeight });
+            return true;
+        }
+    }
+
+    uint32 start = first;
+    for (uint32 index = first + 1; index < end; index++) {
+        const auto& previous = chunks[index - 1];
+        uint32 marker        = 0;
+        if (previous.length >= sizeof(uint32) && data.Copy<uint32>(previous.GetDataOffset() + previous.length - sizeof(uint32), marker) &&
+            Endian::BigToNative(marker) == DEFLATE_FLUSH_MARKER) {
+            segments.push_back({ start, index, 0, 0 });
+            start = index;
+        }
+    }
+    segments.push_back({ start, end, 0, 0 });
+    return false;
+}
+
+// Inflates the data of a segment straight from its IDAT chunks, read in small blocks with DataCache::ReadAt (the only
+// method of the cache that can be used from several threads).
+class SegmentInflater
+{
+    GView::Utils::DataCache& data;
+    const ChunkIndex& chunks;
+    GView::Decoding::ZLIB::StreamInflater inflater;
+    std::vector<uint8> input;
+    std::vector<uint8> scratch;
+    uint32 nextChunk;
+    uint32 endChunk;
+    uint64 offset;
+    uint64 remaining;
+
+    bool HasInput()
+    {
+        while (remaining == 0 && nextChunk < endChunk) {
+            offset    = chunks[nextChunk].GetDataOffset();
+            remaining = chunks[nextChunk].length;
+            nextChunk++;
+        }
+        return remaining > 0;
+    }
+    bool Feed()
+    {
+        const auto size = static_cast<uint32>(std::min<uint64>(remaining, input.size()));
+        CHECK(data.ReadAt(offset, std::span<uint8>(input.data(), size)), false, "Unable to read %u bytes of image data from offset %llu", size, offset);
+        inflater.SetInput(BufferView(input.data(), size));
+        offset += size;
+        remaining -= size;
+        return true;
+    }
+
+  public:
+    SegmentInflater(GView::Utils::DataCache& _data, const ChunkIndex& _chunks) : data(_data), chunks(_chunks)
+    {
+        nextChunk = 0;
+        endChunk  = 0;
+        offset    = 0;
+        remaining = 0;
+    }
+
+    // only the segment that starts the image data has the zlib header, the others are raw deflate data
+    bool Init(uint32 firstChunk, uint32 endChunk, bool zlibHeader)
+    {
+        input.resize(SEGMENT_READ_SIZE);
+        this->nextChunk = firstChunk;
+        this->endChunk  = endChunk;
+        offset    = 0;
+        remaining = 0;
+        return inflater.Init(!zlibHeader);
+    }
+    // fills `output` entirely, fails if the data of the segment ends before
+    bool Read(uint8* output, uint32 size)
+    {
+        while (size > 0) {
+            if (inflater.NeedsInput() && (!HasInput() || !Feed())) {
+                return false;
+            }
+            uint32 written = 0;
+            if (!inflater.Inflate(output, size, written) || (written == 0 && inflater.IsFinished())) {
+                return false;
+            }
+            output += written;
+            size -= written;
+        }
+        return true;
+    }
+    // inflates the rest of the segment (stops once more than `limit` bytes were produced), `size` receives their number
+    bool Count(uint64 limit, uint64& size)
+    {
+        scratch.resize(SEGMENT_READ_SIZE);
+        size = 0;
+        while (size <= limit && !inflater.IsFinished()) {
+            if (inflater.NeedsInput()) {
+                if (!HasInput()) {
+                    break;
+                }
+                CHECK(Feed(), false, "");
+            }
+            uint32 written = 0;
+            if (!inflater.Inflate(scratch.data(), static_cast<uint32>(scratch.size()), written)) {
+                return false;
+            }
+            size += written;
+        }
+        return true;
+    }
+};
+
+bool Decoder::DecodeSegments(Image& img)
+{
+    std::vector<ImageDataSegment> segments;
+    const bool rowsKnown = FindImageDataSegments(segments);
+    if (segments.size() < 2 || std::thread::hardware_concurrency() < 2) {
+        return false; // a single segment (or a single thread)
+    }
+
+    const uint64 rowSize = ((uint64) width * channels * bitDepth + 7) / 8;
+    if (rowSize >= 0x7FFFFFFF) {
+        return false;
+    }
+    const uint32 lineSize   = static_cast<uint32>(rowSize) + 1;
+    const uint64 imageSize  = (uint64) lineSize * height;
+    const uint32 firstChunk = segments[0].firstChunk;
+    const auto last         = static_cast<uint32>(segments.size() - 1);
+
+    // The segments are proven independent before any pixel is decoded: zlib rejects a back reference that points before
+    // the start of a segment, and only the first DEFLATE_WINDOW_SIZE bytes of a segment can have one. Without an iDOT
+    // layout the segments (but the last one) are inflated entirely to find their rows.
+    std::atomic<bool> valid{ true };
+    ParallelFor(last + 1, [&](uint32 index) {
+        auto& segment    = segments[index];
+        const bool count = !rowsKnown && index < last;
+        if (index == 0 && !count) {
+            return;
+        }
+        SegmentInflater inflater(data, chunks);
+        uint64 size = 0;
+        if (!inflater.Init(segment.firstChunk, segment.endChunk, index == 0) || !inflater.Count(count ? imageSize : DEFLATE_WINDOW_SIZE, size)) {
+            valid = false;
+        } else if (count) {
+            if (size > imageSize || size % lineSize != 0) {
+                valid = false;
+            }
+            segment.rows = static_cast<uint32>(size / lineSize);
+        }
+    });
+    if (!valid) {
+        return false;
+    }
+    if (!rowsKnown) {
+        uint32 row = 0;
+        for (uint32 index = 0; index < last; index++) {
+            segments[index].firstRow = row;
+            row += segments[index].rows;
+            if (row > height) {
+                return false;
+            }
+        }
+        segments[last].firstRow = row;
+        segments[last].rows     = height - row;
+    }
+    // segments without scanlines have nothing to decode (after a flush at the end of the data, for example)
+    std::erase_if(segments, [](const ImageDataSegment& segment) { return segment.rows == 0; });
+
+    constexpr uint8 SEGMENT_PENDING = 0;
+    constexpr uint8 SEGMENT_DECODED = 1;
+    constexpr uint8 SEGMENT_FAILED  = 2;
+    std::vector<std::atomic<uint8>> states(segments.size());
+
+    // every segment is inflated, unfiltered and stored straight into its rows of the image, only two scanlines are kept
+    auto decodeSegment = [&](uint32 index) {
+        auto& segment = segments[index];
+        SegmentInflater inflater(data, chunks);
+        CHECK(inflater.Init(segment.firstChunk, segment.endChunk, segment.firstChunk == firstChunk), false, "");
+
+        std::vector<uint8> lines((size_t) lineSize * 2, 0);
+        uint8* previous = lines.data();
+        uint8* current  = lines.data() + lineSize;
+        for (uint32 row = 0; row < segment.rows; row++) {
+            CHECK(inflater.Read(current, lineSize), false, "Fail to read scanline %u", segment.firstRow + row);
+            if (row == 0 && index > 0 && current[0] > static_cast<uint8>(FilterType::Sub)) {
+                // the first scanline is filtered against the last one of the previous segment (which was handed out first)
+                states[index - 1].wait(SEGMENT_PENDING);
+                CHECK(states[index - 1] == SEGMENT_DECODED, false, "");
+                memcpy(previous, segments[index - 1].lastLine.data(), lineSize);
+            }
+            CHECK(UnfilterScanline(current[0], current + 1, previous + 1, lineSize - 1, bytesPerPixel), false, "Scanline %u", segment.firstRow + row);
+            StoreScanline(img, current + 1, segment.firstRow + row, 0, 1, width);
+            std::swap(previous, current);
+        }
+        segment.lastLine.assign(previous, previous + lineSize);
+
+        // the scanlines of the next segment can not be part of this one (the serial decoder ignores the data after the last row)
+        if (index + 1 < segments.size()) {
+            uint64 extra = 0;
+            CHECK(inflater.Count(0, extra) && extra == 0, false, "Image data segment %u has more scanlines than expected", index);
+        }
+        return true;
+    };
+    ParallelFor(static_cast<uint32>(segments.size()), [&](uint32 index) {
+        const bool decoded = decodeSegment(index);
+        states[index]      = decoded ? SEGMENT_DECODED : SEGMENT_FAILED;
+        states[index].notify_all();
+        if (!decoded) {
+            valid = false;
+        }
+    });
+
+    return valid;
+}
+
+bool Decoder::ReadHeader(const IhdrChunk& ihdr)
+{
+    width     = Endian::BigToNative(ihdr.width);
+    height    = Endian::BigToNative(ihdr.height);
+    bitDepth  = ihdr.bitDepth;
+    colorType = ihdr.colorType;
+    interlace = ihdr.interlace;
+    channels  = ChannelsForColorType(colorType);
+
+    CHECK(width > 0 && height > 0, false, "Invalid image size: %u x %u", width, height);
+    CHECK(channels > 0, false, "Invalid color type: %u", colorType);
+    CHECK(IsValidBitDepth(colorType, bitDepth), false, "Invalid bit depth %u for color type %u", bitDepth, colorType);
+    CHECK(ihdr.compression == 0, false, "Unknown compression method: %u", ihdr.compression);
+    CHECK(ihdr.filter == 0, false, "Unknown filter method: %u", ihdr.filter);
+    CHECK(interlace <= 1, false, "Unknown interlace method: %u", interlace);
+
+    bytesPerPixel = std::max<uint32>(1, (channels * bitDepth) / 8);
+
+    CHECK(ReadChunksUntilImageData(), false, "");
+    CHECK(colorType != 3 || paletteSize > 0, false, "Indexed-color image without a PLTE chunk");
+    CHECK(inflater.Init(), false, "");
+
+    return true;
+}
+
+bool Decoder::DecodeImageData(Image& img, Reference<View::ImageViewer::LoadImageProgressInterface> progress)
+{
+    if (interlace == 0) {
+        return DecodePass(img, 0, 0, 1, 1);
+    }
+
+    for (uint32 pass = 0; pass < 7; pass++) {
+        if (progress.IsValid()) {
+            blockWidth  = ADAM7_BLOCK_WIDTH[pass];
+            blockHeight = ADAM7_BLOCK_HEIGHT[pass];
+        }
+        CHECK(DecodePass(img, ADAM7_START_X[pass], ADAM7_START_Y[pass], ADAM7_STEP_X[pass], ADAM7_STEP_Y[pass]), false, "Adam7 pass %u", pass + 1);
+        if (progress.IsValid()) {
+            CHECK(progress->OnImageLoadProgress(img, pass + 1, 7), false, "Image loading canceled");
+        }
+    }
+    return true;
+}
+
+bool Decoder::Decode(const IhdrChunk& ihdr, Image& img, Reference<View::ImageViewer::LoadImageProgressInterface> progress)
+{
+    CHECK(ReadHeader(ihdr), false, "");
+    CHECK(img.Create(width, height), false, "Fail to create a %u x %u image", width, height);
+
+    // the serial inflater was not used yet, it is the fallback if the image data can not be split in independent segments
+    // (or if one of them turns out to be corrupted)
+    if (interlace == 0 && DecodeSegments(img)) {
+        return true;
+    }
+    return DecodeImageData(img, progress);
+}
+
+bool Decoder::DecodeScaled(const IhdrChunk& ihdr, Image& img, uint32 divider)
+{
+    CHECK(ReadHeader(ihdr), false, "");
+
+    // the decoded pixels are accumulated in the downscaler, the full resolution image is never created
+    View::ImageViewer::ImageDownscaler scaler;
+    CHECK(scaler.Init(width, height, divider), false, "");
+    downscaler = &scaler;
+    const bool result = DecodeImageData(img, nullptr);
+    downscaler        = nullptr;
+    CHECK(result, false, "");
+
+    return scaler.Finish(img);
+}
+
+bool Decoder::DecodeFrame(const IhdrChunk& ihdr, const AnimationFrame& frame, Image& img)
+{
+    CHECK(ReadHeader(ihdr), false, "");
+
+    // same color type, bit depth and interlace method as the default image, only the size is different
+    width  = frame.width;
+    height = frame.height;
+    CHECK(width > 0 && height > 0, false, "Invalid frame size: %u x %u", width, height);
+
+    const auto& first = chunks[frame.firstDataChunk];
+    imageDataType     = first.type;
+    nextChunk         = frame.firstDataChunk + 1;
+    CHECK(SetImageDataChunk(first), false, "");
+
+    CHECK(img.Create(width, height), false, "Fail to create a %u x %u image", width, height);
+    return DecodeImageData(img, nullptr);
+}
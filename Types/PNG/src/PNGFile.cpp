@@ -1,9 +1,62 @@
 #include "png.hpp"
 
 using namespace GView::Type::PNG;
+using namespace GView::Utils;
+
+// decoded images are kept as their size followed by the pixels
+static bool FindDecodedImage(const DecodedObjects::Key& key, Image& img)
+{
+    Buffer buffer;
+    if (!DecodedObjects::Find(key, buffer)) {
+        return false;
+    }
+    CHECK(buffer.GetLength() >= 2 * sizeof(uint32), false, "");
+    uint32 width, height;
+    memcpy(&width, buffer.GetData(), sizeof(uint32));
+    memcpy(&height, buffer.GetData() + sizeof(uint32), sizeof(uint32));
+    CHECK(buffer.GetLength() == 2 * sizeof(uint32) + (uint64) width * height * sizeof(Pixel), false, "");
+    CHECK(img.Create(width, height), false, "Fail to create a %u x %u image", width, height);
+
+    // the pixels of the image are contiguous (row after row), same as in the buffer
+    const uint64 rowSize = (uint64) width * sizeof(Pixel);
+    auto px              = buffer.GetData() + 2 * sizeof(uint32);
+    auto row             = reinterpret_cast<uint8*>(img.GetPixelsBuffer());
+    for (uint32 y = 0; y < height; y++, px += rowSize, row += rowSize) {
+        memcpy(row, px, rowSize);
+    }
+    return true;
+}
+
+static void AddDecodedImage(const DecodedObjects::Key& key, const Image& img)
+{
+    const uint32 width  = img.GetWidth();
+    const uint32 height = img.GetHeight();
+    const uint64 size   = 2 * sizeof(uint32) + (uint64) width * height * sizeof(Pixel);
+    if (size > DecodedObjects::GetMemoryBudget()) {
+        return;
+    }
+
+    Buffer buffer;
+    buffer.Resize(size);
+    memcpy(buffer.GetData(), &width, sizeof(uint32));
+    memcpy(buffer.GetData() + sizeof(uint32), &height, sizeof(uint32));
+    const uint64 rowSize = (uint64) width * sizeof(Pixel);
+    auto px              = buffer.GetData() + 2 * sizeof(uint32);
+    auto row             = reinterpret_cast<const uint8*>(img.GetPixelsBuffer());
+    for (uint32 y = 0; y < height; y++, px += rowSize, row += rowSize) {
+        memcpy(px, row, rowSize);
+    }
+    DecodedObjects::Add(key, buffer);
+}
 
 PNGFile::PNGFile()
 {
+    isAnimated          = false;
+    defaultImageIsFrame = false;
+    numPlays            = 0;
+    imageKeyComputed    = false;
+    imageKeyValid       = false;
+    crcApplied          = false;
 }
 
 bool PNGFile::Update()
@@ -16,6 +69,7 @@ bool PNGFile::Update()
 
     auto& data    = this->obj->GetData();
     uint64 offset = 0;
+    DataCache::Tag tag(data, "PNG.Chunks");
 
     // Get and save the PNG signature and IHDR chunks from the file into object attributes
     CHECK(data.Copy<Signature>(offset, signature), false, "");
@@ -24,21 +78,119 @@ bool PNGFile::Update()
     CHECK(data.Copy<IhdrChunk>(offset, ihdr), false, "");
     offset += sizeof(IhdrChunk);
 
+    // single pass over the chunk headers, shared by the viewers, the panels and the CRC verification
+    errList.Clear();
+    CHECK(chunks.Build(data, errList), false, "");
+    CHECK(ReadAnimationFrames(), false, "");
+
+    imageKeyComputed = false;
+    imageKeyValid    = false;
+
     return true;
 }
 
+bool PNGFile::GetImageKey(DecodedObjects::Key& key, uint32 divider)
+{
+    // images that would not be kept are not looked for (the key is not even computed)
+    const uint64 width  = (Endian::BigToNative(ihdr.width) + divider - 1) / divider;
+    const uint64 height = (Endian::BigToNative(ihdr.height) + divider - 1) / divider;
+    if (2 * sizeof(uint32) + width * height * sizeof(Pixel) > DecodedObjects::GetMemoryBudget()) {
+        return false;
+    }
+
+    if (!imageKeyComputed) {
+        // the content is identified by the stored CRCs: only 4 bytes are read for every chunk (the image data is not hashed)
+        auto& data = this->obj->GetData();
+        DataCache::Tag tag(data, "PNG.ImageKey");
+        DecodedObjects::KeyBuilder builder;
+        builder.Update(BufferView(&ihdr, sizeof(ihdr)));
+        imageKeyValid = true;
+        for (const auto& chunk : chunks) {
+            uint32 crc = 0;
+            if (!data.ReadAt(chunk.GetDataOffset() + chunk.length, std::span<uint8>(reinterpret_cast<uint8*>(&crc), sizeof(crc)))) {
+                imageKeyValid = false;
+                break;
+            }
+            builder.Update(BufferView(&chunk.offset, sizeof(chunk.offset)));
+            builder.Update(BufferView(&chunk.length, sizeof(chunk.length)));
+            builder.Update(BufferView(&chunk.type, sizeof(chunk.type)));
+            builder.Update(BufferView(&crc, sizeof(crc)));
+        }
+        imageKey         = builder.GetKey(DecodedObjects::Transform::PngImage);
+        imageKeyComputed = true;
+    }
+    key = imageKey;
+    return imageKeyValid;
+}
+
 bool PNGFile::LoadImageToObject(Image& img, uint32 index)
 {
-    Buffer buf;
-    auto bf = obj->GetData().GetEntireFile();
-    
-    if (bf.IsValid() == false) {
-        buf = this->obj->GetData().CopyEntireFile();
-        CHECK(buf.IsValid(), false, "Fail to copy Entire file");
-        bf = (BufferView) buf;
+    if (isAnimated && (defaultImageIsFrame || index > 0)) {
+        return LoadAnimationFrame(img, defaultImageIsFrame ? index : index - 1, 1);
+    }
+
+    DecodedObjects::Key key;
+    const bool keyValid = GetImageKey(key, 1);
+    if (keyValid && FindDecodedImage(key, img)) {
+        return true;
+    }
+
+    // decode the IDAT stream directly from the cache (the file is never loaded entirely in memory)
+    DataCache::Tag tag(this->obj->GetData(), "PNG.Decoder");
+    Decoder decoder(this->obj->GetData(), chunks);
+    CHECK(decoder.Decode(ihdr, img), false, "Fail to decode PNG image");
+    if (keyValid) {
+        AddDecodedImage(key, img);
+    }
+
+    return true;
+}
+
+bool PNGFile::LoadImageToObjectProgressive(Image& img, uint32 index, Reference<View::ImageViewer::LoadImageProgressInterface> progress)
+{
+    if (isAnimated && (defaultImageIsFrame || index > 0)) {
+        return LoadAnimationFrame(img, defaultImageIsFrame ? index : index - 1, 1);
+    }
+
+    // a decoded image is shown at once (there is no progress to report)
+    DecodedObjects::Key key;
+    const bool keyValid = GetImageKey(key, 1);
+    if (keyValid && FindDecodedImage(key, img)) {
+        return true;
+    }
+
+    // interlaced images are displayed after each Adam7 pass (a coarse preview is available after the first one)
+    DataCache::Tag tag(this->obj->GetData(), "PNG.Decoder");
+    Decoder decoder(this->obj->GetData(), chunks);
+    CHECK(decoder.Decode(ihdr, img, progress), false, "Fail to decode PNG image");
+    if (keyValid) {
+        AddDecodedImage(key, img);
+    }
+
+    return true;
+}
+
+bool PNGFile::LoadImageToObjectScaled(Image& img, uint32 index, uint32 divider)
+{
+    if (isAnimated && (defaultImageIsFrame || index > 0)) {
+        return LoadAnimationFrame(img, defaultImageIsFrame ? index : index - 1, divider);
     }
 
-    CHECK(img.Create(bf), false, "");
+    // every scale is a separate object (the parameter of the key is the divider)
+    DecodedObjects::Key key;
+    const bool keyValid = GetImageKey(key, divider);
+    key.parameter       = divider;
+    if (keyValid && FindDecodedImage(key, img)) {
+        return true;
+    }
+
+    // rows are box-filtered as they are decoded, only the reduced image is allocated
+    DataCache::Tag tag(this->obj->GetData(), "PNG.Decoder");
+    Decoder decoder(this->obj->GetData(), chunks);
+    CHECK(decoder.DecodeScaled(ihdr, img, divider), false, "Fail to decode PNG image");
+    if (keyValid) {
+        AddDecodedImage(key, img);
+    }
 
     return true;
 }
@@ -10,6 +10,9 @@ Panels::Information::Information(Reference<GView::Type::PNG::PNGFile> _png) : Ta
     issues  = Factory::ListView::Create(this, "x:0,y:21,w:100%,h:10", { "n:Info,w:200" }, ListViewFlags::HideColumns);
 
     this->Update();
+    if (!png->IsChunksCRCApplied()) {
+        GetTimer()->Start(REFRESH_INTERVAL);
+    }
 }
 
 String getColorType(uint8_t colorType)
@@ -76,10 +79,28 @@ void Panels::Information::UpdateGeneralInformation()
     const auto interlaceMethod = png->ihdr.interlace;
     const auto interlaceMethodStr = getInterlaceMethod(interlaceMethod);
     general->AddItem({ "Interlace Method", tempStr.Format("%u: %s", interlaceMethod, interlaceMethodStr.GetText()) });
+
+    // Chunks (from the chunk index)
+    general->AddItem("Chunks");
+    general->AddItem({ "Count", tempStr.Format("%u", png->chunks.GetCount()) });
+    general->AddItem({ "IDAT Chunks", tempStr.Format("%u", png->chunks.GetCountOf(IDAT_CHUNK_TYPE)) });
+
+    if (png->isAnimated) {
+        general->AddItem("Animation (APNG)");
+        general->AddItem({ "Frames", tempStr.Format("%u", (uint32) png->frames.size()) });
+        if (png->numPlays == 0) {
+            general->AddItem({ "Plays", "infinite" });
+        } else {
+            general->AddItem({ "Plays", tempStr.Format("%u", png->numPlays) });
+        }
+        general->AddItem({ "Default Image", png->defaultImageIsFrame ? "first frame" : "not part of the animation" });
+    }
 }
 
 void Panels::Information::UpdateIssues()
 {
+    png->errList.PopulateListView(this->issues);
+    issues->SetVisible(!png->errList.Empty());
 }
 
 void Panels::Information::RecomputePanelsPositions()
@@ -92,8 +113,16 @@ void Panels::Information::RecomputePanelsPositions()
         return;
     }
 
-    issues->SetVisible(false);
-    this->general->Resize(w, h);
+    if (!issues->IsVisible()) {
+        this->general->Resize(w, h);
+        return;
+    }
+
+    // general information on top (at most 18 lines), issues use the rest of the space
+    py = std::min<int>(18, (int) this->general->GetItemsCount() + 3);
+    this->general->Resize(w, py);
+    this->issues->MoveTo(0, py);
+    this->issues->Resize(w, std::max<int>(1, h - py));
 }
 
 void Panels::Information::Update()
@@ -102,3 +131,21 @@ void Panels::Information::Update()
     UpdateIssues();
     RecomputePanelsPositions();
 }
+
+void Panels::Information::Paint(AppCUI::Graphics::Renderer& renderer)
+{
+    if (png->ApplyChunksCRC()) {
+        UpdateIssues();
+        RecomputePanelsPositions();
+    }
+    TabPage::Paint(renderer);
+}
+
+bool Panels::Information::OnTimer()
+{
+    if (!png->HasChunksCRCToApply() && !png->IsChunksCRCApplied()) {
+        return false;
+    }
+    GetTimer()->Stop();
+    return png->HasChunksCRCToApply();
+}
@@ -0,0 +1,128 @@
+#include "png.hpp"
+
+using namespace GView::Type::PNG;
+using namespace AppCUI::Controls;
+
+constexpr const char* FILTER_NAMES[6]        = { "None", "Sub", "Up", "Average", "Paeth", "Invalid" };
+constexpr const char* DEFLATE_BLOCK_NAMES[4] = { "Stored", "Fixed Huffman", "Dynamic Huffman", "Reserved (invalid)" };
+
+Panels::Statistics::Statistics(Reference<GView::Type::PNG::PNGFile> _png) : TabPage("&Statistics")
+{
+    png           = _png;
+    list          = Factory::ListView::Create(this, "d:c", { "n:Field,w:18", "n:Value,w:100" }, ListViewFlags::None);
+    shownVersion  = 0xFFFFFFFF;
+    shownFinished = false;
+    started       = false;
+    rowsCreated   = false;
+    shownChunks   = 0;
+    compressed    = 0;
+    decompressed  = 0;
+}
+
+void Panels::Statistics::CreateRows(const ImageDataStatistics& stats)
+{
+    list->AddItem("Image Data");
+    state            = list->AddItem({ "State", "" });
+    window           = list->AddItem({ "Zlib Window", "" });
+    compressedSize   = list->AddItem({ "Compressed", "" });
+    decompressedSize = list->AddItem({ "Decompressed", "" });
+    ratio            = list->AddItem({ "Ratio", "" });
+
+    list->AddItem("Filter Types");
+    scanlines = list->AddItem({ "Scanlines", "" });
+    for (uint32 type = 0; type < 6; type++) {
+        filters[type] = list->AddItem({ FILTER_NAMES[type], "" });
+    }
+
+    list->AddItem("Deflate Blocks");
+    for (uint32 type = 0; type < 4; type++) {
+        blocks[type] = list->AddItem({ DEFLATE_BLOCK_NAMES[type], "" });
+    }
+
+    if (stats.paletteSize > 0) {
+        LocalString<32> tempStr;
+        list->AddItem("Palette");
+        list->AddItem({ "Entries", tempStr.Format("%u", stats.paletteSize) });
+        usedEntries = list->AddItem({ "Used Entries", "" });
+    }
+
+    // compressed vs decompressed size of every IDAT chunk
+    list->AddItem("IDAT Chunks");
+    rowsCreated = true;
+}
+
+void Panels::Statistics::Update()
+{
+    LocalString<256> tempStr;
+    LocalString<32> offsetStr;
+    NumericFormatter n;
+
+    shownVersion     = png->statistics.GetVersion();
+    const auto stats = png->statistics.GetResult(shownChunks);
+    shownFinished    = stats.finished;
+    if (!rowsCreated) {
+        CreateRows(stats);
+    }
+
+    // only the IDAT chunks processed since the last update are added
+    for (const auto& chunk : stats.chunks) {
+        compressed += chunk.compressed;
+        decompressed += chunk.decompressed;
+        list->AddItem({ offsetStr.Format("0x%llX", chunk.offset), tempStr.Format("%u -> %llu bytes", chunk.compressed, chunk.decompressed) });
+    }
+    shownChunks += stats.chunks.size();
+
+    if (stats.failed) {
+        state.SetText(1, tempStr.Format("failed after %u of %u IDAT chunks", (uint32) shownChunks, stats.imageDataChunks));
+    } else if (stats.finished) {
+        state.SetText(1, "complete");
+    } else {
+        state.SetText(1, tempStr.Format("computing (%u of %u IDAT chunks)", (uint32) shownChunks, stats.imageDataChunks));
+    }
+    if (stats.windowSize) {
+        window.SetText(1, tempStr.Format("%u bytes", stats.windowSize));
+    } else if (shownChunks > 0) {
+        window.SetText(1, "invalid zlib header");
+    }
+    compressedSize.SetText(1, tempStr.Format("%s bytes", n.ToString(compressed, { NumericFormatFlags::None, 10, 3, ',' }).data()));
+    decompressedSize.SetText(1, tempStr.Format("%s bytes", n.ToString(decompressed, { NumericFormatFlags::None, 10, 3, ',' }).data()));
+    if (compressed > 0) {
+        ratio.SetText(1, tempStr.Format("%.2f", (double) decompressed / (double) compressed));
+    }
+
+    scanlines.SetText(1, tempStr.Format("%llu", stats.scanlines));
+    for (uint32 type = 0; type < 6; type++) {
+        const double percent = stats.scanlines ? (double) stats.filters[type] * 100.0 / (double) stats.scanlines : 0.0;
+        filters[type].SetText(1, tempStr.Format("%llu (%.2f%%)", stats.filters[type], percent));
+    }
+    for (uint32 type = 0; type < 4; type++) {
+        blocks[type].SetText(1, tempStr.Format("%u", stats.blocks[type]));
+    }
+    if (stats.paletteSize > 0) {
+        usedEntries.SetText(1, tempStr.Format("%u", stats.usedPaletteEntries));
+    }
+}
+
+void Panels::Statistics::Paint(AppCUI::Graphics::Renderer& renderer)
+{
+    // computed only if the page is shown
+    if (!started) {
+        started = true;
+        if (png->ComputeStatistics()) {
+            GetTimer()->Start(REFRESH_INTERVAL);
+        }
+        Update();
+    } else if (png->statistics.GetVersion() != shownVersion) {
+        Update();
+    }
+    TabPage::Paint(renderer);
+}
+
+bool Panels::Statistics::OnTimer()
+{
+    if (shownFinished) {
+        GetTimer()->Stop();
+        return false;
+    }
+    return png->statistics.GetVersion() != shownVersion;
+}
@@ -0,0 +1,266 @@
+#include "png.hpp"
+
+using namespace GView::Type::PNG;
+using namespace GView::Decoding::ZLIB;
+
+constexpr uint32 STATISTICS_READ_SIZE      = 0x100000;
+constexpr uint32 STATISTICS_OUTPUT_SIZE    = 0x10000;
+constexpr uint32 MAX_PALETTE_ENTRIES       = 256;
+constexpr auto STATISTICS_PUBLISH_INTERVAL = std::chrono::milliseconds(100);
+
+// splits the inflated stream in scanlines (following the Adam7 passes for interlaced images)
+class ScanlineWalker
+{
+    struct Pass {
+        uint32 width; // pixels per scanline
+        uint32 rows;
+    };
+    std::vector<Pass> passes;
+    uint32 pass, row;
+    uint32 lineSize, filled;
+    std::vector<uint8> current, previous;
+
+    uint8 bitDepth, channels, bytesPerPixel;
+    bool countPaletteEntries;
+    bool paletteUsage[MAX_PALETTE_ENTRIES];
+
+    void StartPass()
+    {
+        for (; pass < passes.size() && (passes[pass].width == 0 || passes[pass].rows == 0); pass++) {
+        }
+        row    = 0;
+        filled = 0;
+        if (pass < passes.size()) {
+            lineSize = static_cast<uint32>(((uint64) passes[pass].width * channels * bitDepth + 7) / 8) + 1;
+            current.assign(lineSize, 0);
+            previous.assign(lineSize, 0);
+        }
+    }
+
+    void OnScanline(ImageDataStatistics& stats)
+    {
+        stats.scanlines++;
+        stats.filters[std::min<uint8>(current[0], 5)]++;
+
+        // palette indexes are only known after the scanline is reconstructed
+        if (countPaletteEntries && UnfilterScanline(current[0], current.data() + 1, previous.data() + 1, lineSize - 1, bytesPerPixel)) {
+            const uint32 mask = (1U << bitDepth) - 1;
+            for (uint32 x = 0; x < passes[pass].width; x++) {
+                const uint32 bitOffset = x * bitDepth;
+                paletteUsage[(current[1 + (bitOffset >> 3)] >> (8 - bitDepth - (bitOffset & 7))) & mask] = true;
+            }
+            std::swap(current, previous);
+        }
+    }
+
+  public:
+    ScanlineWalker(const IhdrChunk& ihdr, bool palette)
+    {
+        const uint32 width  = Endian::BigToNative(ihdr.width);
+        const uint32 height = Endian::BigToNative(ihdr.height);
+
+        bitDepth            = ihdr.bitDepth;
+        channels            = ihdr.colorType == 2 ? 3 : (ihdr.colorType == 4 ? 2 : (ihdr.colorType == 6 ? 4 : 1));
+        bytesPerPixel       = std::max<uint8>(1, (channels * bitDepth) / 8);
+        countPaletteEntries = palette && bitDepth <= 8;
+        memset(paletteUsage, 0, sizeof(paletteUsage));
+
+        if (ihdr.interlace == 1) {
+            constexpr uint32 startX[7] = { 0, 4, 0, 2, 0, 1, 0 };
+            constexpr uint32 startY[7] = { 0, 0, 4, 0, 2, 0, 1 };
+            constexpr uint32 stepX[7]  = { 8, 8, 4, 4, 2, 2, 1 };
+            constexpr uint32 stepY[7]  = { 8, 8, 8, 4, 4, 2, 2 };
+            for (uint32 i = 0; i < 7; i++) {
+                passes.push_back({ width > startX[i] ? (width - startX[i] + stepX[i] - 1) / stepX[i] : 0,
+                                   height > startY[i] ? (height - startY[i] + stepY[i] - 1) / stepY[i] : 0 });
+            }
+        } else {
+            passes.push_back({ width, height });
+        }
+        pass = 0;
+        StartPass();
+    }
+
+    void Add(const uint8* data, uint32 size, ImageDataStatistics& stats)
+    {
+        // bytes after the last scanline are ignored
+        while (size > 0 && pass < passes.size()) {
+            const uint32 count = std::min<uint32>(size, lineSize - filled);
+            memcpy(current.data() + filled, data, count);
+            filled += count;
+            data += count;
+            size -= count;
+
+            if (filled == lineSize) {
+                OnScanline(stats);
+                filled = 0;
+                if (++row == passes[pass].rows) {
+                    pass++;
+                    StartPass();
+                }
+            }
+        }
+    }
+
+    uint32 GetUsedPaletteEntries(uint32 paletteSize) const
+    {
+        uint32 count = 0;
+        for (uint32 i = 0; i < paletteSize && i < MAX_PALETTE_ENTRIES; i++) {
+            count += paletteUsage[i] ? 1 : 0;
+        }
+        return count;
+    }
+};
+
+StatisticsWorker::StatisticsWorker() : data(nullptr), stopRequested(false), version(0)
+{
+    memset(&ihdr, 0, sizeof(ihdr));
+    result = {};
+}
+
+StatisticsWorker::~StatisticsWorker()
+{
+    Stop();
+}
+
+void StatisticsWorker::Stop()
+{
+    stopRequested = true;
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+bool StatisticsWorker::Start(Object* obj, const IhdrChunk& _ihdr, const ChunkIndex& chunks)
+{
+    CHECK(!thread.joinable(), false, "Statistics are already computed");
+
+    // the data is read by the thread with ReadAt (nothing is read or copied here, whatever the object is)
+    data = &obj->GetData();
+
+    // everything the thread needs is copied, the chunk index and the IHDR of the object are never used from the thread
+    ihdr = _ihdr;
+    imageData.clear();
+    for (const auto& chunk : chunks) {
+        if (chunk.type == IDAT_CHUNK_TYPE) {
+            imageData.push_back(chunk);
+        }
+    }
+    const auto plte = chunks.FindNext(PLTE_CHUNK_TYPE);
+
+    result                 = {};
+    result.imageDataChunks = static_cast<uint32>(imageData.size());
+    result.paletteSize     = (ihdr.colorType == 3 && plte != INVALID_CHUNK_INDEX) ? std::min<uint32>(chunks[plte].length / 3, MAX_PALETTE_ENTRIES) : 0;
+
+    thread = std::thread(&StatisticsWorker::Run, this);
+    return true;
+}
+
+void StatisticsWorker::Publish(const ImageDataStatistics& local)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    // only the new chunk entries are copied
+    result.chunks.insert(result.chunks.end(), local.chunks.begin() + result.chunks.size(), local.chunks.end());
+    result.windowSize         = local.windowSize;
+    result.scanlines          = local.scanlines;
+    result.usedPaletteEntries = local.usedPaletteEntries;
+    result.finished           = local.finished;
+    result.failed             = local.failed;
+    memcpy(result.filters, local.filters, sizeof(result.filters));
+    memcpy(result.blocks, local.blocks, sizeof(result.blocks));
+    version++;
+}
+
+ImageDataStatistics StatisticsWorker::GetResult(size_t firstChunk)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    // the chunk entries that are already known are not copied
+    ImageDataStatistics copy{};
+    copy.chunks.assign(result.chunks.begin() + std::min(firstChunk, result.chunks.size()), result.chunks.end());
+    copy.imageDataChunks    = result.imageDataChunks;
+    copy.windowSize         = result.windowSize;
+    copy.scanlines          = result.scanlines;
+    copy.paletteSize        = result.paletteSize;
+    copy.usedPaletteEntries = result.usedPaletteEntries;
+    copy.finished           = result.finished;
+    copy.failed             = result.failed;
+    memcpy(copy.filters, result.filters, sizeof(copy.filters));
+    memcpy(copy.blocks, result.blocks, sizeof(copy.blocks));
+    return copy;
+}
+
+void StatisticsWorker::Run()
+{
+    ImageDataStatistics local{};
+    local.paletteSize = result.paletteSize;
+
+    ScanlineWalker walker(ihdr, local.paletteSize > 0);
+    StreamInflater inflater;
+    std::vector<uint8> output(STATISTICS_OUTPUT_SIZE);
+    std::vector<uint8> input(STATISTICS_READ_SIZE);
+
+    local.failed = !inflater.Init();
+    inflater.SetBlockCounting(true);
+    auto published = std::chrono::steady_clock::now();
+
+    for (uint32 index = 0; index < imageData.size() && !local.failed && !stopRequested; index++) {
+        const auto& chunk = imageData[index];
+        const uint64 end  = chunk.GetDataOffset() + chunk.length;
+        uint64 produced   = 0;
+
+        for (uint64 pos = chunk.GetDataOffset(); pos < end && !local.failed && !inflater.IsFinished() && !stopRequested;) {
+            const auto size = static_cast<uint32>(std::min<uint64>(STATISTICS_READ_SIZE, end - pos));
+            if (!data->ReadAt(pos, std::span<uint8>(input.data(), size))) {
+                local.failed = true;
+                break;
+            }
+            const BufferView bv(input.data(), size);
+            if (index == 0 && pos == chunk.GetDataOffset() && size >= 2) {
+                // CMF: compression method in the low nibble, log2(window size) - 8 in the high nibble
+                const uint8 cmf = bv.GetData()[0];
+                if ((cmf & 0x0F) == 8 && (((uint32) cmf << 8) | bv.GetData()[1]) % 31 == 0) {
+                    local.windowSize = 1U << ((cmf >> 4) + 8);
+                }
+            }
+
+            inflater.SetInput(bv);
+            for (;;) {
+                uint32 written = 0;
+                if (!inflater.Inflate(output.data(), STATISTICS_OUTPUT_SIZE, written)) {
+                    local.failed = true;
+                    break;
+                }
+                walker.Add(output.data(), written, local);
+                produced += written;
+                if (written == 0 || inflater.IsFinished()) {
+                    break;
+                }
+            }
+            pos += size;
+        }
+
+        local.chunks.push_back({ chunk.offset, chunk.length, produced });
+        for (uint32 type = 0; type < 4; type++) {
+            local.blocks[type] = inflater.GetBlockCount(static_cast<DeflateBlockType>(type));
+        }
+        local.usedPaletteEntries = walker.GetUsedPaletteEntries(local.paletteSize);
+        local.finished           = index + 1 == imageData.size();
+        const auto now           = std::chrono::steady_clock::now();
+        if (local.finished || now - published >= STATISTICS_PUBLISH_INTERVAL) {
+            Publish(local);
+            published = now;
+        }
+    }
+
+    if (imageData.empty() || local.failed) {
+        local.finished = true;
+        Publish(local);
+    }
+}
+
+bool PNGFile::ComputeStatistics()
+{
+    return statistics.Start(this->obj, ihdr, chunks);
+}
@@ -0,0 +1,361 @@
+#include "png.hpp"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#    define PNG_UNFILTER_X64
+#    include <immintrin.h>
+#    ifdef _MSC_VER
+#        include <intrin.h>
+#        define TARGET_AVX2
+#    else
+#        define TARGET_AVX2 __attribute__((target("avx2")))
+#    endif
+#endif
+
+namespace GView::Type::PNG
+{
+using UnfilterFunction = void (*)(uint8* row, const uint8* previous, uint32 rowSize);
+
+constexpr uint32 FILTER_TYPES_COUNT = 5;
+constexpr uint32 MAX_BPP            = 8;
+
+// ======================================================[Scalar]======================================================
+static inline uint8 PaethPredictor(uint8 a, uint8 b, uint8 c)
+{
+    // a = left, b = above, c = upper left
+    const int32 p  = (int32) a + (int32) b - (int32) c;
+    const int32 pa = std::abs(p - (int32) a);
+    const int32 pb = std::abs(p - (int32) b);
+    const int32 pc = std::abs(p - (int32) c);
+
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    if (pb <= pc) {
+        return b;
+    }
+    return c;
+}
+
+static void UnfilterScalar(uint8 filterType, uint8* row, const uint8* previous, uint32 rowSize, uint32 bpp)
+{
+    switch (static_cast<FilterType>(filterType)) {
+    case FilterType::Sub:
+        for (uint32 i = bpp; i < rowSize; i++) {
+            row[i] += row[i - bpp];
+        }
+        break;
+
+    case FilterType::Up:
+        for (uint32 i = 0; i < rowSize; i++) {
+            row[i] += previous[i];
+        }
+        break;
+
+    case FilterType::Average:
+        for (uint32 i = 0; i < bpp && i < rowSize; i++) {
+            row[i] += previous[i] >> 1;
+        }
+        for (uint32 i = bpp; i < rowSize; i++) {
+            row[i] += (uint8) (((uint32) row[i - bpp] + (uint32) previous[i]) >> 1);
+        }
+        break;
+
+    case FilterType::Paeth:
+        for (uint32 i = 0; i < bpp && i < rowSize; i++) {
+            row[i] += previous[i]; // left and upper left are 0 --> the predictor is always the byte above
+        }
+        for (uint32 i = bpp; i < rowSize; i++) {
+            row[i] += PaethPredictor(row[i - bpp], previous[i], previous[i - bpp]);
+        }
+        break;
+    }
+}
+
+// bytes in [start, rowSize) that were not handled by a vectorized kernel (rowSize is not a multiple of bpp)
+static void UnfilterScalarTail(uint8 filterType, uint8* row, const uint8* previous, uint32 start, uint32 rowSize, uint32 bpp)
+{
+    for (uint32 i = start; i < rowSize; i++) {
+        const uint8 a = i >= bpp ? row[i - bpp] : 0;
+        const uint8 b = previous[i];
+        const uint8 c = i >= bpp ? previous[i - bpp] : 0;
+
+        switch (static_cast<FilterType>(filterType)) {
+        case FilterType::Sub:
+            row[i] += a;
+            break;
+        case FilterType::Up:
+            row[i] += b;
+            break;
+        case FilterType::Average:
+            row[i] += (uint8) (((uint32) a + (uint32) b) >> 1);
+            break;
+        case FilterType::Paeth:
+            row[i] += PaethPredictor(a, b, c);
+            break;
+        }
+    }
+}
+
+template <uint8 Filter, uint32 BPP>
+static void UnfilterScalarKernel(uint8* row, const uint8* previous, uint32 rowSize)
+{
+    // fixed bpp --> the compiler can unroll the inner loops
+    UnfilterScalar(Filter, row, previous, rowSize, BPP);
+}
+
+#ifdef PNG_UNFILTER_X64
+// ======================================================[SSE2]========================================================
+// Sub, Average and Paeth depend on the previous pixel, so a whole pixel (all its channels) is reconstructed at once.
+// Pixels are moved with 4 or 8 byte loads/stores; the bytes that do not belong to the current pixel are masked out
+// and written back unchanged. The last pixels (where such an access would go past the scanline) are moved with an
+// exact size copy.
+template <uint32 SIZE>
+static inline __m128i LoadBytes(const uint8* p)
+{
+    uint64 value = 0;
+    memcpy(&value, p, SIZE);
+    return _mm_cvtsi64_si128(static_cast<int64>(value));
+}
+
+template <uint32 SIZE>
+static inline void StoreBytes(uint8* p, __m128i bytes)
+{
+    const uint64 value = static_cast<uint64>(_mm_cvtsi128_si64(bytes));
+    memcpy(p, &value, SIZE);
+}
+
+template <uint32 BPP, uint8 Filter, typename Step>
+static inline void UnfilterPixelsSSE2(uint8* row, const uint8* previous, uint32 rowSize, Step step)
+{
+    constexpr uint32 WIDE   = BPP <= 4 ? 4 : 8;
+    constexpr uint64 MASK64 = BPP == 8 ? ~0ULL : ((1ULL << (BPP * 8)) - 1);
+    const __m128i mask      = _mm_cvtsi64_si128(static_cast<int64>(MASK64));
+    const uint32 end        = rowSize - rowSize % BPP;
+    uint32 i                = 0;
+
+    if constexpr (WIDE != BPP) {
+        for (; i < end && i + WIDE <= rowSize; i += BPP) {
+            const auto x     = LoadBytes<WIDE>(row + i);
+            const auto pixel = step(_mm_and_si128(x, mask), _mm_and_si128(LoadBytes<WIDE>(previous + i), mask));
+            StoreBytes<WIDE>(row + i, _mm_or_si128(_mm_and_si128(pixel, mask), _mm_andnot_si128(mask, x)));
+        }
+    }
+    for (; i < end; i += BPP) {
+        StoreBytes<BPP>(row + i, step(LoadBytes<BPP>(row + i), LoadBytes<BPP>(previous + i)));
+    }
+    UnfilterScalarTail(Filter, row, previous, end, rowSize, BPP);
+}
+
+template <uint32 BPP>
+static void UnfilterSubSSE2(uint8* row, const uint8* previous, uint32 rowSize)
+{
+    __m128i a = _mm_setzero_si128();
+    UnfilterPixelsSSE2<BPP, (uint8) FilterType::Sub>(row, previous, rowSize, [&a](__m128i x, __m128i) {
+        a = _mm_add_epi8(a, x);
+        return a;
+    });
+}
+
+static void UnfilterUpSSE2(uint8* row, const uint8* previous, uint32 rowSize)
+{
+    uint32 i = 0;
+    for (; i + 16 <= rowSize; i += 16) {
+        const auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previous + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), _mm_add_epi8(x, b));
+    }
+    for (; i < rowSize; i++) {
+        row[i] += previous[i];
+    }
+}
+
+template <uint32 BPP>
+static void UnfilterAverageSSE2(uint8* row, const uint8* previous, uint32 rowSize)
+{
+    const __m128i one = _mm_set1_epi8(1);
+    __m128i a         = _mm_setzero_si128();
+    UnfilterPixelsSSE2<BPP, (uint8) FilterType::Average>(row, previous, rowSize, [&a, one](__m128i x, __m128i b) {
+        // _mm_avg_epu8 rounds up: (a + b + 1) >> 1 --> subtract the lost low bit to get (a + b) >> 1
+        const auto avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+        a              = _mm_add_epi8(avg, x);
+        return a;
+    });
+}
+
+static inline __m128i Abs16(__m128i x)
+{
+    // SSE2 has no _mm_abs_epi16 (SSSE3)
+    return _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+}
+
+static inline __m128i Select(__m128i mask, __m128i ifTrue, __m128i ifFalse)
+{
+    return _mm_or_si128(_mm_and_si128(mask, ifTrue), _mm_andnot_si128(mask, ifFalse));
+}
+
+template <uint32 BPP>
+static void UnfilterPaethSSE2(uint8* row, const uint8* previous, uint32 rowSize)
+{
+    // the predictor needs 9 bits of precision --> the channels are widened to 16 bits
+    const __m128i zero     = _mm_setzero_si128();
+    const __m128i byteMask = _mm_set1_epi16(0xFF);
+    __m128i a              = zero;
+    __m128i c              = zero;
+
+    UnfilterPixelsSSE2<BPP, (uint8) FilterType::Paeth>(row, previous, rowSize, [&](__m128i x, __m128i b) {
+        b = _mm_unpacklo_epi8(b, zero);
+        x = _mm_unpacklo_epi8(x, zero);
+
+        // p = a + b - c  ==>  p - a = b - c, p - b = a - c, p - c = (b - c) + (a - c)
+        auto pa             = _mm_sub_epi16(b, c);
+        auto pb             = _mm_sub_epi16(a, c);
+        auto pc             = Abs16(_mm_add_epi16(pa, pb));
+        pa                  = Abs16(pa);
+        pb                  = Abs16(pb);
+        const auto smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+        const auto nearest  = Select(_mm_cmpeq_epi16(pa, smallest), a, Select(_mm_cmpeq_epi16(pb, smallest), b, c));
+
+        a = _mm_and_si128(_mm_add_epi16(x, nearest), byteMask);
+        c = b;
+        return _mm_packus_epi16(a, a);
+    });
+}
+
+// ======================================================[AVX2]========================================================
+// Only the Up filter has no dependency between neighbour bytes and benefits from the wider registers.
+TARGET_AVX2 static void UnfilterUpAVX2(uint8* row, const uint8* previous, uint32 rowSize)
+{
+    uint32 i = 0;
+    for (; i + 32 <= rowSize; i += 32) {
+        const auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        const auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(previous + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + i), _mm256_add_epi8(x, b));
+    }
+    for (; i < rowSize; i++) {
+        row[i] += previous[i];
+    }
+}
+
+static bool IsAVX2Supported()
+{
+#    ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx     = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#    else
+    return __builtin_cpu_supports("avx2");
+#    endif
+}
+#endif
+
+// ======================================================[Dispatch]====================================================
+struct UnfilterKernels {
+    UnfilterFunction functions[FILTER_TYPES_COUNT][MAX_BPP + 1];
+
+    template <uint32 BPP>
+    void SetScalar()
+    {
+        functions[(uint8) FilterType::Sub][BPP]     = UnfilterScalarKernel<(uint8) FilterType::Sub, BPP>;
+        functions[(uint8) FilterType::Up][BPP]      = UnfilterScalarKernel<(uint8) FilterType::Up, BPP>;
+        functions[(uint8) FilterType::Average][BPP] = UnfilterScalarKernel<(uint8) FilterType::Average, BPP>;
+        functions[(uint8) FilterType::Paeth][BPP]   = UnfilterScalarKernel<(uint8) FilterType::Paeth, BPP>;
+    }
+
+#ifdef PNG_UNFILTER_X64
+    template <uint32 BPP>
+    void SetSSE2()
+    {
+        functions[(uint8) FilterType::Sub][BPP]     = UnfilterSubSSE2<BPP>;
+        functions[(uint8) FilterType::Up][BPP]      = UnfilterUpSSE2;
+        functions[(uint8) FilterType::Average][BPP] = UnfilterAverageSSE2<BPP>;
+        functions[(uint8) FilterType::Paeth][BPP]   = UnfilterPaethSSE2<BPP>;
+    }
+#endif
+
+    UnfilterKernels(UnfilterKernel kernel)
+    {
+        memset(functions, 0, sizeof(functions));
+        SetScalar<1>();
+        SetScalar<2>();
+        SetScalar<3>();
+        SetScalar<4>();
+        SetScalar<6>();
+        SetScalar<8>();
+
+#ifdef PNG_UNFILTER_X64
+        if (kernel == UnfilterKernel::Scalar) {
+            return;
+        }
+        // For 1 and 2 bytes per pixel the byte-by-byte dependency chain is as short as it gets, and for 3 and 6 bytes
+        // per pixel the overlapping pixel loads/stores stall on store forwarding - the cheap Sub and Average filters
+        // are faster with the scalar code in these cases (see benchmark/UnfilterBenchmark.cpp).
+        for (uint32 bpp = 1; bpp <= MAX_BPP; bpp++) {
+            functions[(uint8) FilterType::Up][bpp] = UnfilterUpSSE2;
+        }
+        SetSSE2<4>();
+        SetSSE2<8>();
+        functions[(uint8) FilterType::Paeth][3] = UnfilterPaethSSE2<3>;
+        functions[(uint8) FilterType::Paeth][6] = UnfilterPaethSSE2<6>;
+
+        if (kernel == UnfilterKernel::AVX2) {
+            for (uint32 bpp = 1; bpp <= MAX_BPP; bpp++) {
+                functions[(uint8) FilterType::Up][bpp] = UnfilterUpAVX2;
+            }
+        }
+#endif
+    }
+};
+
+UnfilterKernel GetBestUnfilterKernel()
+{
+#ifdef PNG_UNFILTER_X64
+    static const UnfilterKernel best = IsAVX2Supported() ? UnfilterKernel::AVX2 : UnfilterKernel::SSE2;
+    return best;
+#else
+    return UnfilterKernel::Scalar;
+#endif
+}
+
+bool UnfilterScanline(UnfilterKernel kernel, uint8 filterType, uint8* row, const uint8* previous, uint32 rowSize, uint32 bpp)
+{
+    static const UnfilterKernels scalar(UnfilterKernel::Scalar);
+    static const UnfilterKernels sse2(UnfilterKernel::SSE2);
+    static const UnfilterKernels avx2(UnfilterKernel::AVX2);
+
+    if (filterType == (uint8) FilterType::None) {
+        return true;
+    }
+    CHECK(filterType < FILTER_TYPES_COUNT, false, "Invalid filter type: %u", filterType);
+    CHECK(bpp > 0 && bpp <= MAX_BPP, false, "Invalid bytes per pixel: %u", bpp);
+
+    const UnfilterKernels* kernels = &scalar;
+#ifdef PNG_UNFILTER_X64
+    if (kernel == UnfilterKernel::AVX2 && GetBestUnfilterKernel() == UnfilterKernel::AVX2) {
+        kernels = &avx2;
+    } else if (kernel != UnfilterKernel::Scalar) {
+        kernels = &sse2;
+    }
+#endif
+
+    auto fn = kernels->functions[filterType][bpp];
+    CHECK(fn, false, "Unsupported bytes per pixel: %u", bpp);
+    fn(row, previous, rowSize);
+
+    return true;
+}
+
+bool UnfilterScanline(uint8 filterType, uint8* row, const uint8* previous, uint32 rowSize, uint32 bpp)
+{
+    return UnfilterScanline(GetBestUnfilterKernel(), filterType, row, previous, rowSize, bpp);
+}
+} // namespace GView::Type::PNG
@@ -0,0 +1,56 @@
+#include "png.hpp"
+
+using namespace GView::Type::PNG;
+
+WorkerPool::WorkerPool() : lastId(0)
+{
+    // the thread that waits for a parallel loop takes tasks too, at least one thread is needed for the background jobs
+    const uint32 count = std::max<uint32>(1, std::thread::hardware_concurrency()) - 1;
+    for (uint32 i = 0; i < std::max<uint32>(1, count); i++) {
+        threads.emplace_back(&WorkerPool::Work, this);
+    }
+}
+
+WorkerPool& WorkerPool::Get()
+{
+    // never destroyed: the threads are not joined while the plugin is unloaded (or the process exits)
+    static WorkerPool* pool = new WorkerPool();
+    return *pool;
+}
+
+uint64 WorkerPool::Submit(std::function<void()> job)
+{
+    uint64 id;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        id = ++lastId;
+        jobs.push_back({ id, std::move(job) });
+    }
+    changed.notify_one();
+    return id;
+}
+
+bool WorkerPool::Cancel(uint64 id)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = std::find_if(jobs.begin(), jobs.end(), [id](const Job& job) { return job.id == id; });
+    if (it == jobs.end()) {
+        return false;
+    }
+    jobs.erase(it);
+    return true;
+}
+
+void WorkerPool::Work()
+{
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            changed.wait(guard, [this]() { return !jobs.empty(); });
+            job = std::move(jobs.front().run);
+            jobs.pop_front();
+        }
+        job();
+    }
+}
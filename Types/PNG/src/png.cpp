@@ -32,21 +32,27 @@ PLUGIN_EXPORT bool Validate(const AppCUI::Utils::BufferView& buf, const std::str
         return false;
     }
 
-    // Check if there is at least one IDAT (Image Data) chunk. This is done by searching for the IDAT chunk type
-    // The IDAT chunk is the compressed image data and it appears among the first chunks in the file
+    // Check if there is at least one IDAT (Image Data) chunk. The chunk headers are followed (using their length)
+    // until an IDAT chunk is found. Large ancillary chunks (e.g. iCCP) may push the first IDAT outside the buffer,
+    // in which case a consistent chunk list up to the end of the buffer is accepted.
     uint64 offset     = sizeof(PNG::Signature) + sizeof(PNG::IhdrChunk);
     uint64 bufSize    = buf.GetLength();
     const uint8* data = buf.GetData();
-    bool foundIDAT    = false;
 
-    while (!foundIDAT && offset < bufSize) {
-        if (memcmp(data + offset, PNG::IDAT_CHUNK, PNG::CHUNK_TYPE_SIZE) == 0) {
-            foundIDAT = true;
+    while (offset + sizeof(PNG::ChunkHeader) <= bufSize) {
+        auto header         = reinterpret_cast<const PNG::ChunkHeader*>(data + offset);
+        const uint32 length = Endian::BigToNative(header->length);
+
+        if (header->type == PNG::IDAT_CHUNK_TYPE) {
+            return true;
+        }
+        if (header->type == PNG::IEND_CHUNK_TYPE || length > PNG::MAX_CHUNK_LENGTH) {
+            return false;
         }
-        offset++;
+        offset += sizeof(PNG::ChunkHeader) + (uint64) length + PNG::CRC_SIZE;
     }
 
-    return foundIDAT;
+    return true;
 }
 
 PLUGIN_EXPORT TypeInterface* CreateInstance()
@@ -57,10 +63,9 @@ PLUGIN_EXPORT TypeInterface* CreateInstance()
 void CreateBufferView(Reference<GView::View::WindowInterface> win, Reference<PNG::PNGFile> png)
 {
     BufferViewer::Settings settings;
+    LocalString<32> name;
 
-    auto& data            = png->obj->GetData();
-    const uint64 dataSize = data.GetSize();
-    uint64 offset         = 0;
+    const uint64 dataSize = png->obj->GetData().GetSize();
     uint8 colorIndex      = 0;
 
     const ColorPair unknownColor        = ColorPair{ Color::Red, Color::DarkBlue };
@@ -73,116 +78,32 @@ void CreateBufferView(Reference<GView::View::WindowInterface> win, Reference<PNG
     const auto colorCount = colors.size();
 
     settings.AddZone(0, sizeof(PNG::Signature), colors[colorIndex++], "PNG Signature");
-    offset += sizeof(PNG::Signature);
-
-    settings.AddZone(offset, sizeof(PNG::IhdrChunk), colors[colorIndex++], "IHDR Chunk");
-    offset += sizeof(PNG::IhdrChunk);
 
-    // return;
+    // the zones are taken from the chunk index (no chunk header is read again), unknown data ranges are merged in file order
+    const auto& unknownRanges = png->chunks.GetUnknownRanges();
+    auto unknown              = unknownRanges.begin();
 
-    while (offset < dataSize) {
-        uint32 chunkLength;
-        uint32 chunkType;
-        uint32 chunkSize;
-
-        // The first 4 bytes of a chunk are the length of the chunk data
-        if (!data.Copy<uint32>(offset, chunkLength)) {
-            break;
+    for (const auto& chunk : png->chunks) {
+        for (; unknown != unknownRanges.end() && unknown->offset < chunk.offset; unknown++) {
+            settings.AddZone(unknown->offset, unknown->size, unknownColor, "Unknown Data");
         }
 
-        // The size bytes are in the opposite order in the file. We need to reverse them to get the actual size
-        chunkLength = reverseBytes32(chunkLength);
+        const auto type = chunk.GetTypeName();
+        name.Format("%.*s Chunk", (int) type.size(), type.data());
 
-        // The next 4 bytes are the chunk type (e.g. IHDR, IDAT, IEND, sRGB, etc.)
-        if (!data.Copy<uint32>(offset + PNG::CHUNK_TYPE_SIZE, chunkType)) {
-            break;
+        if (PNG::IsKnownChunkType(chunk.type)) {
+            settings.AddZone(chunk.offset, chunk.GetSize(), colors[colorIndex++], name);
+            colorIndex %= colorCount;
+        } else {
+            settings.AddZone(chunk.offset, chunk.GetSize(), unknownColor, name);
         }
-
-        // Compute the size of the chunk based on the length of the chunk data, which is variable and the size of the chunk type, 
-        // length and CRC fields (4 + 4 + 4 = 12 bytes)
-        chunkSize = PNG::CHUNK_LENGTH_SIZE + PNG::CHUNK_TYPE_SIZE + chunkLength + PNG::CRC_SIZE;
-
-        switch (chunkType) {
-        case PNG::SRGB_CHUNK_TYPE:
-            // ADD_ZONE("sRGB Chunk");
-            settings.AddZone(offset, chunkSize, colors[colorIndex++], "sRGB Chunk");
-            break;
-
-        case PNG::PLTE_CHUNK_TYPE:
-            settings.AddZone(offset, chunkSize, colors[colorIndex++], "PLTE Chunk");
-            break;
-
-        case PNG::IDAT_CHUNK_TYPE:
-            settings.AddZone(offset, chunkSize, colors[colorIndex++], "IDAT Chunk");
-            break;
-
-        case PNG::IEND_CHUNK_TYPE:
-            settings.AddZone(offset, chunkSize, colors[colorIndex++], "IEND Chunk");
-            break;
-
-        case PNG::CHRM_CHUNK_TYPE:
-            settings.AddZone(offset, chunkSize, colors[colorIndex++], "cHRM Chunk");
-            break;
-
-        case PNG::GAMA_CHUNK_TYPE:
-            settings.AddZone(offset, chunkSize, colors[colorIndex++], "gAMA Chunk");
-            break;
-
-        case PNG::ICCP_CHUNK_TYPE:
-            settings.AddZone(offset, chunkSize, colors[colorIndex++], "iCCP Chunk");
-            break;
-
-        case PNG::SBIT_CHUNK_TYPE:
-            settings.AddZone(offset, chunkSize, colors[colorIndex++], "sBIT Chunk");
-            break;
-
-        case PNG::BKGD_CHUNK_TYPE:
-            settings.AddZone(offset, chunkSize, colors[colorIndex++], "bKGD Chunk");
-            break;
-
-        case PNG::HIST_CHUNK_TYPE:
-            settings.AddZone(offset, chunkSize, colors[colorIndex++], "hIST Chunk");
-            break;
-
-        case PNG::TRNS_CHUNK_TYPE:
-            settings.AddZone(offset, chunkSize, colors[colorIndex++], "tRNS Chunk");
-            break;
-
-        case PNG::PHYS_CHUNK_TYPE:
-            settings.AddZone(offset, chunkSize, colors[colorIndex++], "pHYs Chunk");
-            break;
-
-        case PNG::SPLT_CHUNK_TYPE:
-            settings.AddZone(offset, chunkSize, colors[colorIndex++], "sPLT Chunk");
-            break;
-
-        case PNG::TIME_CHUNK_TYPE:
-            settings.AddZone(offset, chunkSize, colors[colorIndex++], "tIME Chunk");
-            break;
-
-        case PNG::TEXT_CHUNK_TYPE:
-            settings.AddZone(offset, chunkSize, colors[colorIndex++], "tEXt Chunk");
-            break;
-
-        case PNG::ZTXT_CHUNK_TYPE:
-            settings.AddZone(offset, chunkSize, colors[colorIndex++], "zTXt Chunk");
-            break;
-
-        case PNG::ITXT_CHUNK_TYPE:
-            settings.AddZone(offset, chunkSize, colors[colorIndex++], "iTXt Chunk");
-            break;
-
-        default:
-            chunkSize = 1;
-            settings.AddZone(offset, chunkSize, unknownColor, "Unknown Chunk");
-            break;
-        }
-
-        offset += chunkSize;
-        colorIndex %= colorCount;
+    }
+    for (; unknown != unknownRanges.end(); unknown++) {
+        settings.AddZone(unknown->offset, unknown->size, unknownColor, "Unknown Data");
     }
 
     // If there is any trailing data after the last chunk, we will add it to the buffer viewer
+    const uint64 offset = png->chunks.GetEndOffset();
     if (offset < dataSize) {
         settings.AddZone(offset, dataSize - offset, unknownColor, "Trailing Data");
     }
@@ -195,7 +116,7 @@ void CreateImageView(Reference<GView::View::WindowInterface> win, Reference<PNG:
     GView::View::ImageViewer::Settings settings;
 
     settings.SetLoadImageCallback(png.ToBase<View::ImageViewer::LoadImageInterface>());
-    settings.AddImage(0, png->obj->GetData().GetSize());
+    png->AddImages(settings);
     
     win->CreateViewer(settings);
 }
@@ -204,6 +125,9 @@ PLUGIN_EXPORT bool PopulateWindow(Reference<GView::View::WindowInterface> win)
 {
     auto png = win->GetObject()->GetContentType<PNG::PNGFile>();
     png->Update();
+    // the CRCs are verified in the background, the Information panel reports the invalid ones once they are known
+    png->VerifyChunksCRC();
+    // the statistics are computed in the background once the Statistics panel is shown
 
     // Add viewer
     CreateImageView(win, png);
@@ -211,6 +135,7 @@ PLUGIN_EXPORT bool PopulateWindow(Reference<GView::View::WindowInterface> win)
 
     // Add panels
     win->AddPanel(Pointer<TabPage>(new PNG::Panels::Information(png)), true);
+    win->AddPanel(Pointer<TabPage>(new PNG::Panels::Statistics(png)), true);
 
     return true;
 }